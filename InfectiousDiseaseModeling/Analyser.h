@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+// Disease state of an individual as seen by the analysers
+enum AnalyserState : std::uint8_t {
+	AnalyserSusceptible,
+	AnalyserInfected,
+	AnalyserRecovered
+};
+
+// Read-only structure of arrays view of the population at the end of an epoch. The arrays are valid until analyse returns
+struct PopulationView {
+	int epoch;
+	int individual_count;
+	const int* locations;
+	const std::uint8_t* states; // AnalyserState of every individual
+	const std::uint8_t* epochs_infected;
+};
+
+// Read-only view of the location graph in compressed sparse row form
+struct LocationGraphView {
+	int location_count;
+	const int* offsets; // location_count + 1 entries
+	const int* neighbours;
+};
+
+// Analyser is the interface of in-situ analyses. analyse runs on a worker thread while the simulation advances the next epoch,
+// and is never called concurrently for the same analyser. Shared object plugins export a factory named create_analyser
+class Analyser {
+public:
+	virtual ~Analyser() { }
+	virtual void analyse(const PopulationView& population, const LocationGraphView& location_graph) = 0;
+	virtual void finish() { } // Called once after the last epoch
+};
+
+// Signature of the create_analyser function exported by a plugin, declare it extern "C"
+typedef Analyser* (*CreateAnalyserFunction)();
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <sstream>
+#include "AnalyserHost.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#endif
+
+AnalyserHost::~AnalyserHost() {
+
+	wait_for_workers();
+	analysers_.clear();
+#if defined(__unix__) || defined(__APPLE__)
+	for (void* plugin_handle : plugin_handles_)
+		dlclose(plugin_handle);
+#endif
+}
+
+// Load every shared object of a semicolon separated list and create its analyser. Returns false if any plugin failed to load
+bool AnalyserHost::load_plugins(const std::string& plugin_paths) {
+
+	bool all_loaded = true;
+	std::stringstream plugin_paths_stream(plugin_paths);
+	std::string plugin_path;
+
+	while (std::getline(plugin_paths_stream, plugin_path, ';')) {
+		if (plugin_path.empty())
+			continue;
+#if defined(__unix__) || defined(__APPLE__)
+		void* plugin_handle = dlopen(plugin_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+		CreateAnalyserFunction create_analyser = plugin_handle ? reinterpret_cast<CreateAnalyserFunction>(dlsym(plugin_handle, "create_analyser")) : nullptr;
+		if (create_analyser == nullptr) {
+			std::cout << "Cannot load analyser plugin " << plugin_path << ": " << dlerror() << std::endl;
+			if (plugin_handle)
+				dlclose(plugin_handle);
+			all_loaded = false;
+			continue;
+		}
+		plugin_handles_.push_back(plugin_handle);
+		analysers_.push_back(std::unique_ptr<Analyser>(create_analyser()));
+#else
+		std::cout << "Analyser plugins are not supported on this platform: " << plugin_path << std::endl;
+		all_loaded = false;
+#endif
+	}
+	return all_loaded;
+}
+
+// Add an analyser compiled into the simulation
+void AnalyserHost::add_analyser(std::unique_ptr<Analyser> analyser) {
+	analysers_.push_back(std::move(analyser));
+}
+
+// Point the analysers at the location graph, the table must outlive the host
+void AnalyserHost::set_location_graph(const NeighborhoodLookupTable& neighborhood_table) {
+	location_graph_.location_count = neighborhood_table.node_count();
+	location_graph_.offsets = neighborhood_table.offsets.data();
+	location_graph_.neighbours = neighborhood_table.neighbours.data();
+}
+
+// Snapshot the population and start one worker thread per analyser
+void AnalyserHost::submit_epoch(int epoch, const std::vector<Individual>& individuals) {
+
+	wait_for_workers(); // The previous epoch may still be reading the snapshot
+
+	int individual_count = static_cast<int>(individuals.size());
+	locations_.resize(individual_count);
+	states_.resize(individual_count);
+	epochs_infected_.resize(individual_count);
+
+	#pragma omp parallel for schedule(static)
+	for (int index = 0; index < individual_count; ++index) {
+		const Individual& current_individual = individuals[index];
+		locations_[index] = current_individual.get_location();
+		states_[index] = current_individual.is_infected() ? AnalyserInfected : (current_individual.is_recovered() ? AnalyserRecovered : AnalyserSusceptible);
+		epochs_infected_[index] = current_individual.get_epochs_infected();
+	}
+
+	population_.epoch = epoch;
+	population_.individual_count = individual_count;
+	population_.locations = locations_.data();
+	population_.states = states_.data();
+	population_.epochs_infected = epochs_infected_.data();
+
+	for (std::unique_ptr<Analyser>& analyser : analysers_) {
+		Analyser* current_analyser = analyser.get();
+		worker_threads_.push_back(std::thread([this, current_analyser] { current_analyser->analyse(population_, location_graph_); }));
+	}
+}
+
+// Wait for the last epoch and let the analysers report
+void AnalyserHost::finish() {
+	wait_for_workers();
+	for (std::unique_ptr<Analyser>& analyser : analysers_)
+		analyser->finish();
+}
+
+void AnalyserHost::wait_for_workers() {
+	for (std::thread& worker_thread : worker_threads_)
+		worker_thread.join();
+	worker_threads_.clear();
+}
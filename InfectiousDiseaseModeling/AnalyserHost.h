@@ -0,0 +1,40 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Analyser.h"
+#include "Individual.h"
+#include "NeighborhoodLookupTable.h"
+
+// AnalyserHost owns the analysers of a simulation, loaded from shared objects or added directly, and runs them on worker threads.
+// Every submitted epoch is copied into a structure of arrays snapshot; the analysers read it while the simulation continues,
+// and the next submission waits for them first
+class AnalyserHost {
+public:
+	AnalyserHost() : location_graph_(), population_() { } // Default constructor
+	~AnalyserHost();
+	bool load_plugins(const std::string& plugin_paths);
+	void add_analyser(std::unique_ptr<Analyser> analyser);
+	void set_location_graph(const NeighborhoodLookupTable& neighborhood_table);
+	void submit_epoch(int epoch, const std::vector<Individual>& individuals);
+	void finish();
+	bool empty() const;
+private:
+	std::vector<std::unique_ptr<Analyser>> analysers_;
+	std::vector<void*> plugin_handles_; // Closed after the analysers they created are destroyed
+	std::vector<std::thread> worker_threads_;
+	LocationGraphView location_graph_;
+	PopulationView population_;
+	std::vector<int> locations_; // Snapshot arrays behind population_
+	std::vector<std::uint8_t> states_;
+	std::vector<std::uint8_t> epochs_infected_;
+	void wait_for_workers();
+	AnalyserHost(const AnalyserHost&); // Hosts are not copyable
+	AnalyserHost& operator=(const AnalyserHost&);
+};
+
+// Check if there is nothing to run, the simulation skips every analyser hook in that case
+inline bool AnalyserHost::empty() const {
+	return analysers_.empty();
+}
@@ -0,0 +1,66 @@
+#include "AsyncFileWriter.h"
+
+AsyncFileWriter::~AsyncFileWriter() {
+	close();
+}
+
+// Create the file and start the writer thread
+bool AsyncFileWriter::open(const std::string& filename) {
+
+	close();
+	output_file_.open(filename.c_str(), std::ios::binary | std::ios::trunc);
+	if (!output_file_.is_open())
+		return false;
+
+	closing_ = false;
+	writer_thread_ = std::thread(&AsyncFileWriter::write_queued_buffers, this);
+	return true;
+}
+
+// Queue a buffer for writing, the buffer is moved so no copy is made
+void AsyncFileWriter::write(std::vector<char>&& buffer) {
+	{
+		std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+		queued_bytes_ += buffer.size();
+		queue_.push_back(std::move(buffer));
+	}
+	queue_condition_.notify_one();
+}
+
+// Write the remaining buffers, stop the writer thread and close the file
+void AsyncFileWriter::close() {
+
+	if (!writer_thread_.joinable())
+		return;
+	{
+		std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+		closing_ = true;
+	}
+	queue_condition_.notify_one();
+	writer_thread_.join();
+	output_file_.close();
+}
+
+// Get the number of bytes queued but not yet written
+size_t AsyncFileWriter::get_queued_bytes() {
+	std::lock_guard<std::mutex> queue_lock(queue_mutex_);
+	return queued_bytes_;
+}
+
+// Writer thread: wait for buffers and write them outside of the lock
+void AsyncFileWriter::write_queued_buffers() {
+
+	std::unique_lock<std::mutex> queue_lock(queue_mutex_);
+	while (true) {
+		queue_condition_.wait(queue_lock, [this] { return closing_ || !queue_.empty(); });
+		if (queue_.empty())
+			break; // Closing and nothing left to write
+
+		std::vector<char> buffer(std::move(queue_.front()));
+		queue_.pop_front();
+		queue_lock.unlock();
+		output_file_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		queue_lock.lock();
+		queued_bytes_ -= buffer.size();
+	}
+}
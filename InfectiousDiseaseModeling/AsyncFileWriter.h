@@ -0,0 +1,37 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// AsyncFileWriter appends buffers to a binary file from a background thread, so the simulation never waits for the disk.
+// Buffers are written in the order they were queued; close (or the destructor) waits until the queue is drained
+class AsyncFileWriter {
+public:
+	AsyncFileWriter() : closing_(false), queued_bytes_(0) { } // Default constructor
+	~AsyncFileWriter();
+	bool open(const std::string& filename);
+	void write(std::vector<char>&& buffer);
+	void close();
+	bool is_open() const;
+	size_t get_queued_bytes();
+private:
+	std::ofstream output_file_;
+	std::thread writer_thread_;
+	std::mutex queue_mutex_;
+	std::condition_variable queue_condition_;
+	std::deque<std::vector<char>> queue_;
+	bool closing_;
+	size_t queued_bytes_;
+	void write_queued_buffers();
+	AsyncFileWriter(const AsyncFileWriter&); // Writers are not copyable
+	AsyncFileWriter& operator=(const AsyncFileWriter&);
+};
+
+// Check if the writer thread is running
+inline bool AsyncFileWriter::is_open() const {
+	return writer_thread_.joinable();
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+
+// Outcome of one calibration proposal
+struct CalibrationSample {
+	float infectiosity;
+	double distance; // Distance to the observations when the run was stopped
+	int epoch_count; // Epochs simulated before the run was accepted or rejected
+	bool accepted;
+};
+
+// Draw proposals for the infectiosity from a uniform prior
+inline std::vector<float> get_uniform_proposals(int proposal_count, float minimum_infectiosity, float maximum_infectiosity, unsigned int seed) {
+
+	std::mt19937 mersenne_twister_engine(seed);
+	std::uniform_real_distribution<float> prior_distribution(minimum_infectiosity, maximum_infectiosity);
+
+	std::vector<float> proposals(proposal_count);
+	for (float& proposal : proposals)
+		proposal = prior_distribution(mersenne_twister_engine);
+
+	return proposals;
+}
+
+// Approximate Bayesian computation by rejection: every proposed infectiosity is simulated from the initial population and accepted when the
+// distance between its cumulative case curve (hit count per epoch) and the observed one stays within the tolerance. The distance is the sum of
+// the absolute differences so far, which never decreases, so a run is rejected and stopped in the epoch it exceeds the tolerance.
+// Proposals run as an ensemble over the threads, samples receives one entry per proposal in the order of the proposals.
+// The observations cover epochs 0 to total_epochs, so between 1 and 256 of them are needed, throws std::invalid_argument otherwise
+template <typename Model>
+void run_abc_calibration(const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population, const std::vector<int>& observed_cases,
+	const std::vector<float>& proposals, double tolerance, const SimulationOptions& base_options, std::vector<CalibrationSample>& samples) {
+
+	if (observed_cases.empty() || observed_cases.size() > 256)
+		throw std::invalid_argument("run_abc_calibration: between 1 and 256 observed epochs are supported");
+
+	int proposal_count = static_cast<int>(proposals.size());
+	int observed_epoch_count = static_cast<int>(observed_cases.size());
+	std::uint8_t total_epochs = static_cast<std::uint8_t>(observed_cases.size() - 1);
+	samples.resize(proposal_count);
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int proposal_index = 0; proposal_index < proposal_count; ++proposal_index) {
+		CalibrationSample& sample = samples[proposal_index];
+		sample.infectiosity = proposals[proposal_index];
+		sample.distance = 0.0;
+
+		SimulationOptions options(base_options);
+		options.seed = base_options.seed + proposal_index;
+		options.region_statistics = nullptr; // Proposals run concurrently and only their distance is kept
+		options.infectiosity = proposals[proposal_index];
+		options.epoch_observer = [&](int epoch, const std::tuple<int, int, int>& statistics) {
+			if (epoch < 0 || epoch >= observed_epoch_count)
+				return false; // Outside the observations, the run cannot be compared
+			sample.distance += std::abs(std::get<0>(statistics) - observed_cases[epoch]);
+			return sample.distance <= tolerance;
+		};
+
+		PopulationState population(initial_population);
+		std::vector<std::tuple<int, int, int>> epoch_statistics;
+		simulate_compartmental<Model>(total_epochs, neighborhood_table, population, epoch_statistics, options);
+		sample.epoch_count = static_cast<int>(epoch_statistics.size());
+		sample.accepted = sample.distance <= tolerance;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <random>
+#include "Analyser.h"
+#include "CohortSampler.h"
+
+// Draw the cohort in a single pass over the population. Unstratified, one reservoir of cohort_size holds a uniform sample.
+// Stratified, every state keeps its own reservoir and the cohort takes from each in proportion to the size of the state,
+// with at least one member from every state that has individuals
+void CohortSampler::select(const std::vector<Individual>& individuals, int cohort_size, bool stratified, unsigned int seed) {
+
+	static const int STRATUM_COUNT = 3; // One per AnalyserState
+
+	std::mt19937 mersenne_twister_engine(seed);
+	int individual_count = static_cast<int>(individuals.size());
+	cohort_size = std::min(cohort_size, individual_count);
+
+	std::vector<std::vector<int>> reservoirs(stratified ? STRATUM_COUNT : 1);
+	std::vector<int> stratum_sizes(reservoirs.size(), 0);
+
+	for (int index = 0; index < individual_count; ++index) {
+		int stratum = stratified ? get_state(individuals[index]) : 0;
+		std::vector<int>& reservoir = reservoirs[stratum];
+		int seen_count = stratum_sizes[stratum]++;
+
+		if (seen_count < cohort_size) {
+			reservoir.push_back(index);
+		}
+		else {
+			// Keep the individual with probability cohort_size / (seen_count + 1), replacing a random member
+			int replaced = std::uniform_int_distribution<int>(0, seen_count)(mersenne_twister_engine);
+			if (replaced < cohort_size)
+				reservoir[replaced] = index;
+		}
+	}
+
+	// Proportional allocation of the cohort over the strata, a cohort smaller than the number of strata can't hold one of each
+	int nonempty_stratum_count = static_cast<int>(reservoirs.size() - std::count(stratum_sizes.begin(), stratum_sizes.end(), 0));
+	int minimum_allocation = (cohort_size >= nonempty_stratum_count) ? 1 : 0;
+	std::vector<int> allocations(reservoirs.size(), 0);
+	int allocated_count = 0;
+	for (size_t stratum = 0; stratum != reservoirs.size(); ++stratum) {
+		if (stratum_sizes[stratum] == 0)
+			continue;
+		allocations[stratum] = std::max(minimum_allocation, static_cast<int>(static_cast<long long>(cohort_size) * stratum_sizes[stratum] / individual_count));
+		allocated_count += allocations[stratum];
+	}
+
+	// Rounding leaves a few members over (or the minimum allocation takes a few too many), settle them with the largest strata
+	while (allocated_count != cohort_size) {
+		int change = (allocated_count < cohort_size) ? 1 : -1;
+		int largest_stratum = -1;
+		for (int stratum = 0; stratum != static_cast<int>(reservoirs.size()); ++stratum) {
+			bool can_change = (change > 0) ? (allocations[stratum] < static_cast<int>(reservoirs[stratum].size())) : (allocations[stratum] > minimum_allocation);
+			if (can_change && (largest_stratum < 0 || stratum_sizes[stratum] > stratum_sizes[largest_stratum]))
+				largest_stratum = stratum;
+		}
+		allocations[largest_stratum] += change;
+		allocated_count += change;
+	}
+
+	// A random subset of a uniform sample is a uniform sample
+	cohort_.clear();
+	for (size_t stratum = 0; stratum != reservoirs.size(); ++stratum) {
+		std::shuffle(reservoirs[stratum].begin(), reservoirs[stratum].end(), mersenne_twister_engine);
+		cohort_.insert(cohort_.end(), reservoirs[stratum].begin(), reservoirs[stratum].begin() + allocations[stratum]);
+	}
+	std::sort(cohort_.begin(), cohort_.end());
+
+	locations_.clear();
+	states_.clear();
+	recorded_epoch_count_ = 0;
+}
+
+// Append the location and state of every cohort member
+void CohortSampler::record_epoch(const std::vector<Individual>& individuals) {
+
+	for (int individual_index : cohort_) {
+		locations_.push_back(individuals[individual_index].get_location());
+		states_.push_back(get_state(individuals[individual_index]));
+	}
+	++recorded_epoch_count_;
+}
+
+std::uint8_t CohortSampler::get_state(const Individual& individual) {
+	return individual.is_infected() ? AnalyserInfected : (individual.is_recovered() ? AnalyserRecovered : AnalyserSusceptible);
+}
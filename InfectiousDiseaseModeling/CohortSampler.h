@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Individual.h"
+
+// CohortSampler tracks the trajectories of a fixed size random cohort of the population.
+// The cohort is drawn once by reservoir sampling, optionally stratified by the state of the individuals at selection;
+// afterwards every epoch only touches the cohort members
+class CohortSampler {
+public:
+	CohortSampler() : recorded_epoch_count_(0) { } // Default constructor
+	void select(const std::vector<Individual>& individuals, int cohort_size, bool stratified, unsigned int seed);
+	void record_epoch(const std::vector<Individual>& individuals);
+	bool empty() const;
+	const std::vector<int>& get_cohort() const;
+	int get_recorded_epoch_count() const;
+	const std::vector<int>& get_locations() const;
+	const std::vector<std::uint8_t>& get_states() const;
+private:
+	std::vector<int> cohort_; // Indices of the cohort members, in increasing order
+	std::vector<int> locations_; // Location of every member for every recorded epoch, epoch major
+	std::vector<std::uint8_t> states_; // AnalyserState of every member for every recorded epoch, epoch major
+	int recorded_epoch_count_;
+	static std::uint8_t get_state(const Individual& individual);
+};
+
+// Check if no cohort was selected
+inline bool CohortSampler::empty() const {
+	return cohort_.empty();
+}
+
+// Get the indices of the cohort members
+inline const std::vector<int>& CohortSampler::get_cohort() const {
+	return cohort_;
+}
+
+// Get the number of recorded epochs
+inline int CohortSampler::get_recorded_epoch_count() const {
+	return recorded_epoch_count_;
+}
+
+// Get the recorded locations, cohort size entries per epoch
+inline const std::vector<int>& CohortSampler::get_locations() const {
+	return locations_;
+}
+
+// Get the recorded states, cohort size entries per epoch
+inline const std::vector<std::uint8_t>& CohortSampler::get_states() const {
+	return states_;
+}
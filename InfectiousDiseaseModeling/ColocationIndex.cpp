@@ -0,0 +1,51 @@
+#include <algorithm>
+#include "ColocationIndex.h"
+
+// Allocate a ring of window_epochs empty epochs
+void ColocationIndex::open(int window_epochs) {
+	slots_.assign(window_epochs, EpochSlot());
+	next_slot_ = 0;
+	recorded_epoch_count_ = 0;
+}
+
+// Store the current locations, overwriting the oldest epoch once the ring is full. The buffers of the overwritten epoch are reused
+void ColocationIndex::record_epoch(const std::vector<Individual>& individuals, int location_count) {
+
+	EpochSlot& slot = slots_[next_slot_];
+	slot.locations.resize(individuals.size());
+	for (size_t index = 0; index != individuals.size(); ++index)
+		slot.locations[index] = individuals[index].get_location();
+	slot.buckets.build(slot.locations, location_count);
+
+	next_slot_ = (next_slot_ + 1) % slots_.size();
+	recorded_epoch_count_ = std::min(recorded_epoch_count_ + 1, static_cast<int>(slots_.size()));
+}
+
+// For every requested individual, find the distinct individuals that shared a location with it during the last window_epochs epochs.
+// The queries of a batch are independent and answered in parallel
+void ColocationIndex::get_contacts(const std::vector<int>& individual_indices, int window_epochs, std::vector<std::vector<int>>& contacts) const {
+
+	int query_count = static_cast<int>(individual_indices.size());
+	int epoch_count = std::min(window_epochs, recorded_epoch_count_);
+	contacts.resize(query_count);
+
+	#pragma omp parallel for schedule(dynamic, 16)
+	for (int query_index = 0; query_index < query_count; ++query_index) {
+
+		int individual_index = individual_indices[query_index];
+		std::vector<int>& individual_contacts = contacts[query_index];
+		individual_contacts.clear();
+
+		// Walk back from the latest epoch
+		for (int epoch_offset = 1; epoch_offset <= epoch_count; ++epoch_offset) {
+			const EpochSlot& slot = slots_[(next_slot_ + slots_.size() - epoch_offset) % slots_.size()];
+			int location = slot.locations[individual_index];
+			for (const int* occupant = slot.buckets.occupants_begin(location); occupant != slot.buckets.occupants_end(location); ++occupant)
+				if (*occupant != individual_index)
+					individual_contacts.push_back(*occupant);
+		}
+
+		std::sort(individual_contacts.begin(), individual_contacts.end());
+		individual_contacts.erase(std::unique(individual_contacts.begin(), individual_contacts.end()), individual_contacts.end());
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+#include "Individual.h"
+#include "LocationBuckets.h"
+
+// ColocationIndex keeps the location buckets of the last window_epochs epochs in a ring, so contact tracing can ask
+// which individuals shared a location with a given individual without scanning stored trajectories
+class ColocationIndex {
+public:
+	ColocationIndex() : next_slot_(0), recorded_epoch_count_(0) { } // Default constructor
+	void open(int window_epochs);
+	void record_epoch(const std::vector<Individual>& individuals, int location_count);
+	void get_contacts(const std::vector<int>& individual_indices, int window_epochs, std::vector<std::vector<int>>& contacts) const;
+	bool is_open() const;
+	int get_recorded_epoch_count() const;
+private:
+	// Locations of every individual and the individuals of every location during one epoch
+	struct EpochSlot {
+		std::vector<int> locations;
+		LocationBuckets buckets;
+	};
+	std::vector<EpochSlot> slots_;
+	size_t next_slot_; // Slot that the next epoch overwrites, the oldest one once the ring is full
+	int recorded_epoch_count_;
+};
+
+// Check if the index has a window
+inline bool ColocationIndex::is_open() const {
+	return !slots_.empty();
+}
+
+// Get the number of epochs in the index, at most the window
+inline int ColocationIndex::get_recorded_epoch_count() const {
+	return recorded_epoch_count_;
+}
@@ -0,0 +1,6 @@
+#include "CompartmentModel.h"
+
+// Definitions of the transition tables, for the kernels that index them at run time
+constexpr CompartmentRule SirModel::RULES[COMPARTMENT_COUNT];
+constexpr CompartmentRule SeirModel::RULES[COMPARTMENT_COUNT];
+constexpr CompartmentRule SeirsModel::RULES[COMPARTMENT_COUNT];
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include "IndividualParameters.h"
+
+// Disease compartment of an individual, models that skip a compartment never enter it
+enum Compartment : std::uint8_t {
+	CompartmentSusceptible,
+	CompartmentExposed, // Infected but not yet infectious
+	CompartmentInfectious,
+	CompartmentRecovered
+};
+
+static const int COMPARTMENT_COUNT = 4;
+
+// Transition out of a compartment: after duration epochs in the compartment the individual moves to the next compartment,
+// with the given probability per epoch (1 moves right away). A duration of 0 never leaves the compartment on a timer;
+// susceptible individuals leave it by infection, into the next compartment of their rule
+struct CompartmentRule {
+	Compartment next;
+	std::uint8_t duration;
+	float probability;
+};
+
+// A compartment model is a constexpr transition table with one rule per compartment, indexed by Compartment.
+// The state kernel reads the rules as compile-time constants, so deterministic (probability 1) and untimed rules cost no random draw or branch
+
+// Susceptible, infectious, recovered with lifelong immunity, the model of Individual
+struct SirModel {
+	static constexpr CompartmentRule RULES[COMPARTMENT_COUNT] = {
+		{ CompartmentInfectious, 0, 1.0f },
+		{ CompartmentExposed, 0, 1.0f }, // Unused
+		{ CompartmentRecovered, DEFAULT_DISEASE_DURATION + 1, 1.0f }, // Recovers after DiseaseDuration + 1 epochs, like Individual
+		{ CompartmentRecovered, 0, 1.0f }
+	};
+};
+
+// Adds a latent period before the individual becomes infectious
+struct SeirModel {
+	static constexpr CompartmentRule RULES[COMPARTMENT_COUNT] = {
+		{ CompartmentExposed, 0, 1.0f },
+		{ CompartmentInfectious, 3, 1.0f },
+		{ CompartmentRecovered, 7, 1.0f },
+		{ CompartmentRecovered, 0, 1.0f }
+	};
+};
+
+// Adds waning immunity, recovered individuals become susceptible again with a 10% chance per epoch after 14 epochs
+struct SeirsModel {
+	static constexpr CompartmentRule RULES[COMPARTMENT_COUNT] = {
+		{ CompartmentExposed, 0, 1.0f },
+		{ CompartmentInfectious, 3, 1.0f },
+		{ CompartmentRecovered, 7, 1.0f },
+		{ CompartmentSusceptible, 14, 0.1f }
+	};
+};
\ No newline at end of file
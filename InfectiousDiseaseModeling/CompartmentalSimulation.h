@@ -0,0 +1,499 @@
+#pragma once
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "CompartmentModel.h"
+#include "IndividualParameters.h"
+#include "InterventionMask.h"
+#include "LocationBuckets.h"
+#include "NeighborhoodLookupTable.h"
+#include "PopulationState.h"
+#include "VenueTable.h"
+
+// Options of a compartment model simulation
+struct SimulationOptions {
+	SimulationOptions() : seed(std::random_device()()), infectiosity(IndividualParameters().Infectiosity), substeps_per_epoch(1),
+		age_group_count(1), venue_table(nullptr), contact_cap(0), first_epoch(0), group_movement(false), location_regions(nullptr), region_count(0),
+		region_statistics(nullptr) { } // Default constructor
+	unsigned int seed; // Seed of the per-thread random engines, runs with the same seed and thread count are reproducible (see get_run_thread_count)
+	float infectiosity; // Chance of every infectious individual to infect a susceptible one at the same location, per epoch
+	std::vector<Intervention> interventions; // Closures and reopenings of the location graph, applied by epoch and in order within an epoch
+	std::vector<const NeighborhoodLookupTable*> layers; // Movement layers over the locations of the neighbourhood table, which is the only layer when empty
+	std::vector<int> layer_schedule; // Layer of every substep, repeated over the epochs (layer 0 throughout when empty)
+	int substeps_per_epoch; // Movement and infection rounds per epoch, the compartments advance once per epoch
+	int age_group_count; // Age groups of the population, see PopulationState::age_groups
+	std::vector<float> contact_matrix; // Row major age_group_count x age_group_count, scales the transmission from the column group to the row group (all 1 when empty)
+	const VenueTable* venue_table; // Transmission rate multipliers of the locations, all 1 when null
+	int contact_cap; // Every susceptible individual meets at most this many distinct random individuals at its location per substep, 0 mixes everybody
+	std::vector<std::uint8_t> compartment_durations; // Replaces the durations of the timed rules of the model, per compartment (the model durations when empty)
+	std::function<bool(int, const std::tuple<int, int, int>&)> epoch_observer; // Gets the statistics of every epoch, returning false stops the run early
+	int first_epoch; // Epoch to start at, to continue a population saved at the end of the previous epoch
+	bool group_movement; // Moves the individuals location by location with move_population_grouped instead of one by one
+	std::vector<float> stay_probabilities; // Chance to stay at every location per epoch, for simulate_event_driven (1 / (degree + 1) when empty)
+	const std::vector<int>* location_regions; // Region of every location, from 0 to region_count - 1, for the region statistics
+	int region_count; // Regions of location_regions
+	std::vector<int>* region_statistics; // Gets REGION_STATISTIC_COUNT counts per region per epoch, epoch major, when not null
+};
+
+// Counts of a region in the region statistics of a run
+enum RegionStatistic {
+	RegionSusceptible, // Susceptible individuals at the end of the epoch
+	RegionInfected, // Exposed and infectious individuals at the end of the epoch
+	RegionRecovered, // Recovered individuals at the end of the epoch
+	RegionNewInfections // Individuals infected during the epoch, by the location of their infection
+};
+static const int REGION_STATISTIC_COUNT = 4;
+
+static const int BINOMIAL_SPLIT_COUNT = 32; // Largest count drawn individual by individual instead of with a binomial
+
+// Get the threads of the parallel regions of a run: all of them for a standalone run, one for a run nested in an ensemble of runs.
+// A nested run therefore draws the same random numbers as a standalone run with the same seed on one thread
+inline int get_run_thread_count() {
+	return omp_in_parallel() ? 1 : omp_get_max_threads();
+}
+
+// Get one random engine per thread of a run, seeded from the run seed and the thread number
+inline std::vector<std::mt19937> get_run_random_engines(unsigned int seed, int thread_count) {
+	std::vector<std::mt19937> random_engines;
+	for (int thread_number = 0; thread_number < thread_count; ++thread_number) {
+		std::seed_seq seed_sequence = { seed, static_cast<unsigned int>(thread_number) };
+		random_engines.push_back(std::mt19937(seed_sequence));
+	}
+	return random_engines;
+}
+
+// Check the region options of a run and clear its region statistics. Returns the regions of the statistics, 0 when the options ask for none.
+// Throws std::invalid_argument when the options ask for region statistics, but do not give a region below region_count for every location
+inline int get_region_count(const SimulationOptions& options, int location_count, const char* engine_name) {
+	if (options.region_statistics == nullptr)
+		return 0;
+	if (options.location_regions == nullptr || options.location_regions->size() != static_cast<size_t>(location_count))
+		throw std::invalid_argument(std::string(engine_name) + ": the region statistics need the region of every location");
+	for (int region : *options.location_regions)
+		if (region < 0 || region >= options.region_count)
+			throw std::invalid_argument(std::string(engine_name) + ": every region needs to be less than region_count");
+	options.region_statistics->clear();
+	return options.region_count;
+}
+
+// Get the transmission rate multipliers of the locations of a run, null without a venue table.
+// Throws std::invalid_argument when the venue table does not have one row per location
+inline const float* get_rate_multipliers(const SimulationOptions& options, int location_count, const char* engine_name) {
+	if (options.venue_table == nullptr)
+		return nullptr;
+	if (options.venue_table->node_count() != location_count)
+		throw std::invalid_argument(std::string(engine_name) + ": the venue table needs one row per location");
+	return options.venue_table->rate_multipliers.data();
+}
+
+// Get the region counts of the next epoch of a run, zeroed at the end of the region statistics of the options
+inline int* add_region_counts(const SimulationOptions& options) {
+	std::vector<int>& region_statistics = *options.region_statistics;
+	region_statistics.resize(region_statistics.size() + options.region_count * REGION_STATISTIC_COUNT, 0);
+	return region_statistics.data() + region_statistics.size() - options.region_count * REGION_STATISTIC_COUNT;
+}
+
+// Count individuals of a compartment into the counts of their region
+inline void count_region_compartment(int* region_counts, std::uint8_t compartment, int count) {
+	if (compartment == CompartmentSusceptible)
+		region_counts[RegionSusceptible] += count;
+	else if (compartment == CompartmentRecovered)
+		region_counts[RegionRecovered] += count;
+	else
+		region_counts[RegionInfected] += count;
+}
+
+// Add the partial region counts of a thread to the region counts of the epoch. Every thread of the enclosing parallel region calls it once,
+// the sums are integers, so their order does not matter
+inline void merge_region_counts(const std::vector<int>& partial_region_counts, int* region_counts) {
+	#pragma omp critical
+	for (size_t count_index = 0; count_index < partial_region_counts.size(); ++count_index)
+		region_counts[count_index] += partial_region_counts[count_index];
+}
+
+// Advance the timer of an individual in compartment C and follow the rule of C once it expires after duration epochs.
+// The rule is a compile-time constant: untimed rules compile to nothing and deterministic ones draw no random number
+template <typename Model, Compartment C>
+inline void advance_compartment(std::uint8_t& compartment, std::uint8_t& timer, std::uint8_t duration, std::mt19937& random_engine) {
+	constexpr CompartmentRule rule = Model::RULES[C];
+	if (rule.duration == 0)
+		return;
+
+	if (timer < duration) // Saturates, probabilistic rules may keep the individual longer than the duration
+		++timer;
+	if (timer >= duration) {
+		if (rule.probability < 1.0f && std::uniform_real_distribution<float>(0.0f, 1.0f)(random_engine) >= rule.probability)
+			return;
+		compartment = rule.next;
+		timer = 0;
+	}
+}
+
+// Get the durations of the timed rules, from the options or the model. Untimed rules stay untimed whatever their duration.
+// Throws std::invalid_argument when the options give durations, but not one per compartment
+template <typename Model>
+inline void get_compartment_durations(const SimulationOptions& options, std::uint8_t* durations) {
+	if (!options.compartment_durations.empty() && options.compartment_durations.size() != COMPARTMENT_COUNT)
+		throw std::invalid_argument("compartment_durations needs one duration per compartment");
+	for (int compartment = 0; compartment < COMPARTMENT_COUNT; ++compartment)
+		durations[compartment] = options.compartment_durations.empty() ? Model::RULES[compartment].duration : options.compartment_durations[compartment];
+}
+
+// Advance an individual by one epoch, dispatching to the compile-time rule of its compartment
+template <typename Model>
+inline void advance_individual(std::uint8_t& compartment, std::uint8_t& timer, const std::uint8_t* durations, std::mt19937& random_engine) {
+	switch (compartment) {
+	case CompartmentSusceptible: advance_compartment<Model, CompartmentSusceptible>(compartment, timer, durations[CompartmentSusceptible], random_engine); break;
+	case CompartmentExposed: advance_compartment<Model, CompartmentExposed>(compartment, timer, durations[CompartmentExposed], random_engine); break;
+	case CompartmentInfectious: advance_compartment<Model, CompartmentInfectious>(compartment, timer, durations[CompartmentInfectious], random_engine); break;
+	case CompartmentRecovered: advance_compartment<Model, CompartmentRecovered>(compartment, timer, durations[CompartmentRecovered], random_engine); break;
+	}
+}
+
+// Stay in the same spot or move to a neighbouring node, with equal chances. A mask restricts the choices to the open neighbours.
+// Shares the loop among the threads of the enclosing parallel region, random_engine belongs to the calling thread
+inline void move_population(const NeighborhoodLookupTable& neighborhood_table, const InterventionMask* intervention_mask, int* locations,
+	int individual_count, std::mt19937& random_engine) {
+
+	if (intervention_mask == nullptr) {
+		#pragma omp for schedule(static)
+		for (int index = 0; index < individual_count; ++index) {
+			int location = locations[index];
+			int degree = neighborhood_table.degree(location);
+			int choice = std::uniform_int_distribution<int>(0, degree)(random_engine);
+			if (choice < degree)
+				locations[index] = neighborhood_table.neighbours_begin(location)[choice];
+		} // Implicit Barrier
+	}
+	else {
+		#pragma omp for schedule(static)
+		for (int index = 0; index < individual_count; ++index) {
+			int location = locations[index];
+			int degree = intervention_mask->get_open_degree(location);
+			int choice = std::uniform_int_distribution<int>(0, degree)(random_engine);
+			if (choice < degree)
+				locations[index] = intervention_mask->get_open_neighbour(location, choice);
+		} // Implicit Barrier
+	}
+}
+
+// Draw the number of successes of count trials with the given chance. Counts up to BINOMIAL_SPLIT_COUNT sum single draws, which is
+// cheaper than setting up a binomial distribution
+inline int draw_binomial(int count, double probability, std::mt19937& random_engine) {
+	if (count > BINOMIAL_SPLIT_COUNT)
+		return std::binomial_distribution<int>(count, probability)(random_engine);
+
+	int success_count = 0;
+	std::uniform_real_distribution<double> real_random(0.0, 1.0);
+	for (int trial = 0; trial < count; ++trial)
+		success_count += real_random(random_engine) < probability ? 1 : 0;
+	return success_count;
+}
+
+// Move the individuals grouped by location, the same random walk as move_population, reading the neighbours of every location once instead
+// of once per occupant. Up to BINOMIAL_SPLIT_COUNT occupants draw their choice one by one, larger groups split multinomially over the open
+// neighbours and staying, by one binomial per neighbour, and the movers to every neighbour are drawn from the remaining occupants by a
+// partial shuffle of the bucket. location_buckets must group the current locations and is shuffled in place.
+// Shares the loop among the threads of the enclosing parallel region
+inline void move_population_grouped(const NeighborhoodLookupTable& neighborhood_table, const InterventionMask* intervention_mask,
+	LocationBuckets& location_buckets, int* locations, std::mt19937& random_engine) {
+
+	int location_count = neighborhood_table.node_count();
+	#pragma omp for schedule(static)
+	for (int location = 0; location < location_count; ++location) {
+		int remaining_count = location_buckets.occupant_count(location);
+		if (remaining_count == 0)
+			continue;
+		int* occupants = location_buckets.occupants.data() + location_buckets.offsets[location];
+		int degree = intervention_mask ? intervention_mask->get_open_degree(location) : neighborhood_table.degree(location);
+		const int* neighbours = neighborhood_table.neighbours_begin(location);
+		bool all_open = intervention_mask == nullptr || degree == neighborhood_table.degree(location);
+
+		if (remaining_count <= BINOMIAL_SPLIT_COUNT) {
+			std::uniform_int_distribution<int> choice_distribution(0, degree);
+			for (int position = 0; position < remaining_count; ++position) {
+				int choice = choice_distribution(random_engine);
+				if (choice < degree)
+					locations[occupants[position]] = all_open ? neighbours[choice] : intervention_mask->get_open_neighbour(location, choice);
+			}
+			continue;
+		}
+
+		for (int choice = 0; choice < degree && remaining_count > 0; ++choice) {
+			int target = all_open ? neighbours[choice] : intervention_mask->get_open_neighbour(location, choice);
+			for (int moved_count = draw_binomial(remaining_count, 1.0 / (degree + 1 - choice), random_engine); moved_count > 0; --moved_count) {
+				int position = std::uniform_int_distribution<int>(0, remaining_count - 1)(random_engine);
+				locations[occupants[position]] = target;
+				std::swap(occupants[position], occupants[--remaining_count]); // The movers gather at the end of the bucket
+			}
+		} // The remaining occupants stay
+	} // Implicit Barrier
+}
+
+// Simulate the population with a compartment model on the compressed location graph. Every epoch moves the individuals,
+// infects the susceptible ones with the force of infection of their location and advances the compartments.
+// Statistics are (hit, infected, recovered) per simulated epoch, infected counts the exposed and the infectious individuals.
+// Region statistics are gathered in per-thread histograms during the infection and advance passes and merged at the end of every epoch.
+// Throws std::invalid_argument when a layer has another node count than the neighbourhood table, the schedule names a missing layer,
+// the contact matrix is not age_group_count x age_group_count, an individual is in a missing age group or a location in a missing region
+template <typename Model>
+void simulate_compartmental(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, PopulationState& population,
+	std::vector<std::tuple<int, int, int>>& epoch_statistics, const SimulationOptions& options) {
+
+	int individual_count = population.size();
+	int location_count = neighborhood_table.node_count();
+	int* locations = population.locations.data();
+	std::uint8_t* compartments = population.compartments.data();
+	std::uint8_t* timers = population.timers.data();
+	std::uint8_t* hit = population.hit.data();
+
+	// One random engine per thread of the run, seeded from the run seed and the thread number
+	int thread_count = get_run_thread_count();
+	std::vector<std::mt19937> random_engines = get_run_random_engines(options.seed, thread_count);
+
+	std::uint8_t durations[COMPARTMENT_COUNT];
+	get_compartment_durations<Model>(options, durations);
+
+	// Movement layers, every substep switches to the table of its layer without copying it
+	std::vector<const NeighborhoodLookupTable*> layers(options.layers);
+	if (layers.empty())
+		layers.push_back(&neighborhood_table);
+	for (const NeighborhoodLookupTable* layer : layers)
+		if (layer->node_count() != location_count)
+			throw std::invalid_argument("simulate_compartmental: every layer needs the locations of the neighbourhood table");
+	for (int layer_index : options.layer_schedule)
+		if (layer_index < 0 || layer_index >= static_cast<int>(layers.size()))
+			throw std::invalid_argument("simulate_compartmental: the layer schedule names a missing layer");
+	for (const Intervention& intervention : options.interventions) {
+		bool is_edge = intervention.type == InterventionCloseEdge || intervention.type == InterventionReopenEdge;
+		if (intervention.node < 0 || intervention.node >= location_count
+			|| (is_edge && (intervention.other_node < 0 || intervention.other_node >= location_count)))
+			throw std::invalid_argument("simulate_compartmental: every intervention needs to name locations of the neighbourhood table");
+	}
+
+	// The masks are only built when the scenario has interventions, otherwise the unmasked move kernel runs.
+	// Every layer has its own mask, node interventions apply to all layers and edge interventions to the layers with the edge
+	std::vector<InterventionMask> intervention_masks(layers.size());
+	std::vector<Intervention> interventions(options.interventions);
+	std::stable_sort(interventions.begin(), interventions.end(), [](const Intervention& first, const Intervention& second) {
+		return first.epoch < second.epoch;
+	}); // Interventions of the same epoch keep their order, a closure and a reopening of the same node do not commute
+	size_t next_intervention = 0;
+	if (!interventions.empty())
+		for (size_t layer_index = 0; layer_index != layers.size(); ++layer_index)
+			intervention_masks[layer_index].open(*layers[layer_index]);
+
+	// Summed infectivity and infection hazard per location and age group, location major
+	int group_count = options.age_group_count;
+	const std::uint8_t* age_groups = population.age_groups.empty() ? nullptr : population.age_groups.data();
+	const std::uint8_t* infectivities = population.infectivities.empty() ? nullptr : population.infectivities.data();
+	const std::uint8_t* susceptibilities = population.susceptibilities.empty() ? nullptr : population.susceptibilities.data();
+	if (group_count < 1 || (!options.contact_matrix.empty() && options.contact_matrix.size() != static_cast<size_t>(group_count) * group_count))
+		throw std::invalid_argument("simulate_compartmental: the contact matrix needs age_group_count x age_group_count entries");
+	if (age_groups && *std::max_element(population.age_groups.begin(), population.age_groups.end()) >= group_count)
+		throw std::invalid_argument("simulate_compartmental: every age group needs to be less than age_group_count");
+	std::vector<float> contact_matrix(options.contact_matrix);
+	if (contact_matrix.empty())
+		contact_matrix.assign(group_count * group_count, 1.0f);
+	float contact_hazard = -std::log(1.0f - options.infectiosity); // Every infectious contact of multiplier 1 is escaped with chance 1 - infectiosity
+	const float* rate_multipliers = get_rate_multipliers(options, location_count, "simulate_compartmental");
+	std::vector<float> location_infectivities(location_count * group_count);
+	std::vector<std::vector<float>> thread_location_infectivities(options.contact_cap > 0 ? 0 : thread_count,
+		std::vector<float>(location_count * group_count)); // Partial sums of every thread, summed in thread order
+	LocationBuckets location_buckets; // Grouped movement and contact capped mixing work on the occupants of every location
+	std::vector<std::uint8_t> infections(options.contact_cap > 0 ? individual_count : 0);
+	std::vector<float> location_infection_hazards(location_count * group_count);
+	int region_count = get_region_count(options, location_count, "simulate_compartmental");
+	const int* location_regions = region_count > 0 ? options.location_regions->data() : nullptr;
+	epoch_statistics.clear();
+
+	// Repeat for all the epochs
+	for (int current_epoch = options.first_epoch; current_epoch < (total_epochs + 1); ++current_epoch) {
+
+		for (; next_intervention < interventions.size() && interventions[next_intervention].epoch <= current_epoch; ++next_intervention)
+			for (InterventionMask& intervention_mask : intervention_masks)
+				intervention_mask.apply(interventions[next_intervention]);
+
+		int hit_count = 0;
+		int infected_count = 0;
+		int recovered_count = 0;
+		int* region_counts = region_count > 0 ? add_region_counts(options) : nullptr;
+
+		#pragma omp parallel num_threads(thread_count)
+		{
+			std::mt19937& random_engine = random_engines[omp_get_thread_num()];
+			std::vector<int> contact_positions; // Positions of the capped contacts of an individual among the other occupants
+			std::vector<std::uint8_t> contact_marks; // Marks the drawn contact positions, cleared again after every individual
+			std::vector<int> partial_region_counts(region_count * REGION_STATISTIC_COUNT, 0); // Region histogram of this thread
+
+			for (int substep = 0; substep < options.substeps_per_epoch; ++substep) {
+				int step = current_epoch * options.substeps_per_epoch + substep;
+				int layer_index = options.layer_schedule.empty() ? 0 : options.layer_schedule[step % options.layer_schedule.size()];
+				const InterventionMask* intervention_mask = intervention_masks[layer_index].is_open() ? &intervention_masks[layer_index] : nullptr;
+
+				if (options.group_movement) {
+					#pragma omp single
+					location_buckets.build(population.locations, location_count); // Implicit Barrier
+					move_population_grouped(*layers[layer_index], intervention_mask, location_buckets, locations, random_engine);
+				}
+				else
+					move_population(*layers[layer_index], intervention_mask, locations, individual_count, random_engine);
+
+				if (options.contact_cap > 0) {
+					#pragma omp single
+					location_buckets.build(population.locations, location_count); // Implicit Barrier
+
+					// Every susceptible individual meets the other occupants of its location, or contact_cap distinct ones of them when there are
+					// more, and sums the hazards of the infectious ones. The distinct contacts are drawn with Floyd's algorithm, the marks of the
+					// thread find the taken positions in constant time, so the work per location is bounded by its occupants times the cap.
+					// Locations without infectious occupants infect nobody and draw no contacts
+					#pragma omp for schedule(static)
+					for (int location = 0; location < location_count; ++location) {
+						const int* occupants = location_buckets.occupants_begin(location);
+						int occupant_count = location_buckets.occupant_count(location);
+						if (std::none_of(occupants, occupants + occupant_count, [&](int index) { return compartments[index] == CompartmentInfectious; }))
+							continue;
+						float location_hazard = contact_hazard * (rate_multipliers ? rate_multipliers[location] : 1.0f);
+						if (contact_marks.size() < static_cast<size_t>(occupant_count))
+							contact_marks.resize(occupant_count, 0);
+
+						for (int position = 0; position < occupant_count && occupant_count > 1; ++position) {
+							int index = occupants[position];
+							if (compartments[index] != CompartmentSusceptible)
+								continue;
+
+							const float* contact_row = &contact_matrix[(age_groups ? age_groups[index] : 0) * group_count];
+							float infection_hazard = 0.0f;
+							bool meets_everybody = occupant_count - 1 <= options.contact_cap;
+							int contact_count = meets_everybody ? occupant_count - 1 : options.contact_cap;
+							if (!meets_everybody) {
+								contact_positions.clear();
+								for (int last_position = occupant_count - 1 - contact_count; last_position < occupant_count - 1; ++last_position) {
+									int contact_position = std::uniform_int_distribution<int>(0, last_position)(random_engine);
+									if (contact_marks[contact_position])
+										contact_position = last_position; // Taken, the new last position never is
+									contact_marks[contact_position] = 1;
+									contact_positions.push_back(contact_position);
+								}
+								for (int contact_position : contact_positions)
+									contact_marks[contact_position] = 0;
+							}
+							for (int contact_number = 0; contact_number < contact_count; ++contact_number) {
+								int contact_position = meets_everybody ? contact_number : contact_positions[contact_number];
+								int contact_index = occupants[contact_position < position ? contact_position : contact_position + 1]; // Skip the individual itself
+								if (compartments[contact_index] == CompartmentInfectious)
+									infection_hazard += contact_row[age_groups ? age_groups[contact_index] : 0]
+										* (infectivities ? get_multiplier(infectivities[contact_index]) : 1.0f);
+							}
+
+							if (infection_hazard > 0.0f) {
+								float infection_chance = 1.0f - std::exp(-location_hazard * infection_hazard * (susceptibilities ? get_multiplier(susceptibilities[index]) : 1.0f));
+								infections[index] = std::uniform_real_distribution<float>(0.0f, 1.0f)(random_engine) < infection_chance ? 1 : 0;
+							}
+						}
+					} // Implicit Barrier
+
+					// Infections only take effect after the sampling, so individuals infected in this substep are no contacts yet
+					#pragma omp for schedule(static)
+					for (int index = 0; index < individual_count; ++index) {
+						if (infections[index]) {
+							compartments[index] = Model::RULES[CompartmentSusceptible].next;
+							timers[index] = 0;
+							hit[index] = 1;
+							infections[index] = 0;
+							if (location_regions)
+								++partial_region_counts[location_regions[locations[index]] * REGION_STATISTIC_COUNT + RegionNewInfections];
+						}
+					} // Implicit Barrier
+				}
+				else {
+					// Scatter-add the infectivity of the infectious individuals into their location and age group. Every thread adds its
+					// static share of the individuals into its own partial sums, which keeps the float sums independent of the thread timing
+					std::vector<float>& partial_infectivities = thread_location_infectivities[omp_get_thread_num()];
+					std::fill(partial_infectivities.begin(), partial_infectivities.end(), 0.0f);
+					#pragma omp for schedule(static)
+					for (int index = 0; index < individual_count; ++index) {
+						if (compartments[index] == CompartmentInfectious) {
+							int count_index = locations[index] * group_count + (age_groups ? age_groups[index] : 0);
+							partial_infectivities[count_index] += infectivities ? get_multiplier(infectivities[index]) : 1.0f;
+						}
+					} // Implicit Barrier
+
+					// Infection hazard of every age group at every location with infectious individuals: the contact matrix times the
+					// infectivities summed in thread order, scaled by the hazard of one infectious contact and the venue rate of the location.
+					// Locations without infectious individuals skip the product
+					#pragma omp for schedule(static)
+					for (int location = 0; location < location_count; ++location) {
+						float* group_infectivities = &location_infectivities[location * group_count];
+						float* infection_hazards = &location_infection_hazards[location * group_count];
+						float location_infectivity = 0.0f;
+						for (int group = 0; group < group_count; ++group) {
+							int count_index = location * group_count + group;
+							group_infectivities[group] = 0.0f;
+							for (const std::vector<float>& thread_infectivities : thread_location_infectivities)
+								group_infectivities[group] += thread_infectivities[count_index];
+							location_infectivity += group_infectivities[group];
+						}
+						if (location_infectivity == 0.0f) {
+							std::fill(infection_hazards, infection_hazards + group_count, 0.0f);
+							continue;
+						}
+
+						float location_hazard = contact_hazard * (rate_multipliers ? rate_multipliers[location] : 1.0f);
+						for (int group = 0; group < group_count; ++group) {
+							const float* contact_row = &contact_matrix[group * group_count];
+							float infectious_contacts = 0.0f;
+							#pragma omp simd reduction(+:infectious_contacts)
+							for (int source_group = 0; source_group < group_count; ++source_group)
+								infectious_contacts += contact_row[source_group] * group_infectivities[source_group];
+							infection_hazards[group] = location_hazard * infectious_contacts;
+						}
+					} // Implicit Barrier
+
+					// Infect the susceptible individuals with chance 1 - exp(-susceptibility * hazard) of their age group at their location
+					#pragma omp for schedule(static)
+					for (int index = 0; index < individual_count; ++index) {
+						if (compartments[index] == CompartmentSusceptible) {
+							float infection_hazard = location_infection_hazards[locations[index] * group_count + (age_groups ? age_groups[index] : 0)];
+							if (infection_hazard > 0.0f) {
+								float infection_chance = 1.0f - std::exp(-infection_hazard * (susceptibilities ? get_multiplier(susceptibilities[index]) : 1.0f));
+								if (std::uniform_real_distribution<float>(0.0f, 1.0f)(random_engine) < infection_chance) {
+									compartments[index] = Model::RULES[CompartmentSusceptible].next;
+									timers[index] = 0;
+									hit[index] = 1;
+									if (location_regions)
+										++partial_region_counts[location_regions[locations[index]] * REGION_STATISTIC_COUNT + RegionNewInfections];
+								}
+							}
+						}
+					} // Implicit Barrier
+				}
+			}
+
+			// Advance the compartments and gather the statistics
+			#pragma omp for schedule(static) reduction(+:hit_count, infected_count, recovered_count)
+			for (int index = 0; index < individual_count; ++index) {
+				advance_individual<Model>(compartments[index], timers[index], durations, random_engine);
+				hit_count += hit[index];
+				infected_count += (compartments[index] == CompartmentExposed || compartments[index] == CompartmentInfectious) ? 1 : 0;
+				recovered_count += (compartments[index] == CompartmentRecovered) ? 1 : 0;
+				if (location_regions)
+					count_region_compartment(&partial_region_counts[location_regions[locations[index]] * REGION_STATISTIC_COUNT], compartments[index], 1);
+			} // Implicit Barrier
+
+			if (region_counts)
+				merge_region_counts(partial_region_counts, region_counts);
+		}
+
+		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count));
+		if (options.epoch_observer && !options.epoch_observer(current_epoch, epoch_statistics.back()))
+			break;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,198 @@
+#pragma once
+#include <omp.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+
+// Split the count of individuals at a location, each of them stays or moves to a neighbour with equal chances, so the count splits
+// multinomially over the degree + 1 choices. Counts up to BINOMIAL_SPLIT_COUNT draw the choice of every individual, which is cheaper than
+// setting up a binomial, larger ones split by sequential binomials. Both are exact. Adds the share of every target location to
+// target_counts[target * stride], atomically
+inline void split_location_count(const NeighborhoodLookupTable& neighborhood_table, int location, int count, int* target_counts, int stride,
+	std::mt19937& random_engine) {
+
+	int degree = neighborhood_table.degree(location);
+	const int* neighbours = neighborhood_table.neighbours_begin(location);
+	if (count <= BINOMIAL_SPLIT_COUNT) {
+		for (; count > 0; --count) {
+			int choice = std::uniform_int_distribution<int>(0, degree)(random_engine);
+			int target = choice < degree ? neighbours[choice] : location;
+			#pragma omp atomic
+			++target_counts[target * stride];
+		}
+	}
+	else {
+		for (int choice = 0; choice < degree && count > 0; ++choice) {
+			int moved_count = std::binomial_distribution<int>(count, 1.0 / (degree + 1 - choice))(random_engine);
+			if (moved_count > 0) {
+				#pragma omp atomic
+				target_counts[neighbours[choice] * stride] += moved_count;
+				count -= moved_count;
+			}
+		}
+		#pragma omp atomic
+		target_counts[location * stride] += count; // The rest stays
+	}
+}
+
+// Move the susceptible counts of all locations. Shares the loops among the threads of the enclosing parallel region
+inline void move_susceptible_counts(const NeighborhoodLookupTable& neighborhood_table, const std::vector<int>& susceptible_counts,
+	std::vector<int>& moved_susceptible_counts, std::mt19937& random_engine) {
+
+	int location_count = neighborhood_table.node_count();
+	#pragma omp for schedule(static)
+	for (int location = 0; location < location_count; ++location)
+		moved_susceptible_counts[location] = 0;
+
+	#pragma omp for schedule(static)
+	for (int location = 0; location < location_count; ++location) {
+		if (susceptible_counts[location] > 0)
+			split_location_count(neighborhood_table, location, susceptible_counts[location], moved_susceptible_counts.data(), 1, random_engine);
+	} // Implicit Barrier
+}
+
+// Simulate the population with a compartment model, keeping the susceptible individuals that were never hit as a count per location instead
+// of as individuals. Only the hit individuals (infected, recovered and, in models with waning immunity, susceptible again) are agents, they
+// are created at the location of their infection. The dynamics are the same random walk and force of infection as simulate_compartmental,
+// exactly, for homogeneous mixing: the infectiosity, the venue table, the compartment durations, the epoch observer and the first epoch of the
+// options are honoured, the layers, interventions, substeps, age groups, contact cap and the multipliers of the population are not.
+// Memory and movement cost follow the locations and the agents instead of the population. Statistics and region statistics are as
+// simulate_compartmental, the susceptible counts join the region histograms in the infection pass over the locations
+template <typename Model>
+void simulate_susceptible_counts(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population,
+	std::vector<std::tuple<int, int, int>>& epoch_statistics, const SimulationOptions& options) {
+
+	int location_count = neighborhood_table.node_count();
+
+	// The never hit susceptible individuals become counts, everybody else an agent
+	std::vector<int> susceptible_counts(location_count, 0);
+	std::vector<int> moved_susceptible_counts(location_count);
+	PopulationState agents;
+	for (int index = 0; index < initial_population.size(); ++index) {
+		if (initial_population.compartments[index] == CompartmentSusceptible && !initial_population.hit[index]) {
+			++susceptible_counts[initial_population.locations[index]];
+			continue;
+		}
+		agents.locations.push_back(initial_population.locations[index]);
+		agents.compartments.push_back(initial_population.compartments[index]);
+		agents.timers.push_back(initial_population.timers[index]);
+		agents.hit.push_back(initial_population.hit[index]);
+	}
+
+	// One random engine per thread of the run, seeded from the run seed and the thread number
+	int thread_count = get_run_thread_count();
+	std::vector<std::mt19937> random_engines = get_run_random_engines(options.seed, thread_count);
+
+	std::uint8_t durations[COMPARTMENT_COUNT];
+	get_compartment_durations<Model>(options, durations);
+
+	float log_escape_chance = std::log(1.0f - options.infectiosity);
+	const float* rate_multipliers = get_rate_multipliers(options, location_count, "simulate_susceptible_counts");
+	std::vector<int> location_infectious_counts(location_count);
+	std::vector<int> location_infection_counts(location_count);
+	std::vector<float> location_infection_chances(location_count);
+	int region_count = get_region_count(options, location_count, "simulate_susceptible_counts");
+	const int* location_regions = region_count > 0 ? options.location_regions->data() : nullptr;
+	epoch_statistics.clear();
+
+	// Repeat for all the epochs
+	for (int current_epoch = options.first_epoch; current_epoch < (total_epochs + 1); ++current_epoch) {
+
+		int agent_count = agents.size();
+		int hit_count = 0;
+		int infected_count = 0;
+		int recovered_count = 0;
+		int* region_counts = region_count > 0 ? add_region_counts(options) : nullptr;
+
+		#pragma omp parallel num_threads(thread_count)
+		{
+			std::mt19937& random_engine = random_engines[omp_get_thread_num()];
+			std::vector<int> partial_region_counts(region_count * REGION_STATISTIC_COUNT, 0); // Region histogram of this thread
+
+			move_susceptible_counts(neighborhood_table, susceptible_counts, moved_susceptible_counts, random_engine);
+			move_population(neighborhood_table, nullptr, agents.locations.data(), agent_count, random_engine);
+
+			// Count the infectious agents of every location
+			#pragma omp for schedule(static)
+			for (int location = 0; location < location_count; ++location)
+				location_infectious_counts[location] = 0;
+			#pragma omp for schedule(static)
+			for (int index = 0; index < agent_count; ++index) {
+				if (agents.compartments[index] == CompartmentInfectious) {
+					#pragma omp atomic
+					++location_infectious_counts[agents.locations[index]];
+				}
+			} // Implicit Barrier
+
+			// Every susceptible individual of a location escapes every infectious one with chance 1 - infectiosity, independently,
+			// so the infections of a susceptible count are binomial
+			#pragma omp for schedule(static)
+			for (int location = 0; location < location_count; ++location) {
+				int infection_count = 0;
+				float infection_chance = 0.0f;
+				if (location_infectious_counts[location] > 0) {
+					infection_chance = 1.0f - std::exp(log_escape_chance * (rate_multipliers ? rate_multipliers[location] : 1.0f) * location_infectious_counts[location]);
+					if (moved_susceptible_counts[location] > 0)
+						infection_count = std::binomial_distribution<int>(moved_susceptible_counts[location], infection_chance)(random_engine);
+				}
+				moved_susceptible_counts[location] -= infection_count;
+				location_infection_counts[location] = infection_count;
+				location_infection_chances[location] = infection_chance;
+				if (location_regions) {
+					int* location_region_counts = &partial_region_counts[location_regions[location] * REGION_STATISTIC_COUNT];
+					location_region_counts[RegionSusceptible] += moved_susceptible_counts[location];
+					location_region_counts[RegionNewInfections] += infection_count;
+				}
+			} // Implicit Barrier
+
+			// Susceptible agents are infected one by one with the same chance
+			#pragma omp for schedule(static)
+			for (int index = 0; index < agent_count; ++index) {
+				if (agents.compartments[index] == CompartmentSusceptible && location_infection_chances[agents.locations[index]] > 0.0f
+					&& std::uniform_real_distribution<float>(0.0f, 1.0f)(random_engine) < location_infection_chances[agents.locations[index]]) {
+					agents.compartments[index] = Model::RULES[CompartmentSusceptible].next;
+					agents.timers[index] = 0;
+					agents.hit[index] = 1;
+					if (location_regions)
+						++partial_region_counts[location_regions[agents.locations[index]] * REGION_STATISTIC_COUNT + RegionNewInfections];
+				}
+			}
+
+			// The infected individuals of the counts become agents at their location
+			#pragma omp single
+			{
+				susceptible_counts.swap(moved_susceptible_counts);
+				for (int location = 0; location < location_count; ++location) {
+					for (int infection = 0; infection < location_infection_counts[location]; ++infection) {
+						agents.locations.push_back(location);
+						agents.compartments.push_back(Model::RULES[CompartmentSusceptible].next);
+						agents.timers.push_back(0);
+						agents.hit.push_back(1);
+					}
+				}
+				agent_count = agents.size();
+			} // Implicit Barrier
+
+			// Advance the compartments of the agents and gather the statistics
+			#pragma omp for schedule(static) reduction(+:hit_count, infected_count, recovered_count)
+			for (int index = 0; index < agent_count; ++index) {
+				advance_individual<Model>(agents.compartments[index], agents.timers[index], durations, random_engine);
+				hit_count += agents.hit[index];
+				infected_count += (agents.compartments[index] == CompartmentExposed || agents.compartments[index] == CompartmentInfectious) ? 1 : 0;
+				recovered_count += (agents.compartments[index] == CompartmentRecovered) ? 1 : 0;
+				if (location_regions)
+					count_region_compartment(&partial_region_counts[location_regions[agents.locations[index]] * REGION_STATISTIC_COUNT], agents.compartments[index], 1);
+			} // Implicit Barrier
+
+			if (region_counts)
+				merge_region_counts(partial_region_counts, region_counts);
+		}
+
+		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count));
+		if (options.epoch_observer && !options.epoch_observer(current_epoch, epoch_statistics.back()))
+			break;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include <cmath>
+#include <limits>
+#include "EpidemicMetrics.h"
+
+// Weight of the latest epoch in the exponentially smoothed growth rate
+const double EpidemicMetrics::GROWTH_RATE_SMOOTHING = 0.5;
+
+// The initially infected individuals count as infections of the epoch before the first one
+EpidemicMetrics::EpidemicMetrics(int infectious_period, int initial_infected_count)
+	: epoch_(0), previous_hit_count_(initial_infected_count), previous_infected_count_(initial_infected_count),
+	peak_infected_count_(initial_infected_count), peak_epoch_(0), growth_rate_(0.0),
+	recent_new_infections_(infectious_period > 0 ? infectious_period : 1, 0), recent_index_(0), recent_new_infections_sum_(0) {
+
+	recent_new_infections_.back() = initial_infected_count;
+	recent_new_infections_sum_ = initial_infected_count;
+}
+
+// Update the metrics with the statistics of the next epoch
+EpochMetrics EpidemicMetrics::advance_epoch(int hit_count, int infected_count) {
+
+	EpochMetrics metrics;
+	metrics.new_infections = hit_count - previous_hit_count_; // Hit individuals never become susceptible again
+
+	// Running peak
+	if (infected_count > peak_infected_count_) {
+		peak_infected_count_ = infected_count;
+		peak_epoch_ = epoch_;
+	}
+	metrics.peak_infected_count = peak_infected_count_;
+	metrics.peak_epoch = peak_epoch_;
+
+	// Growth rate of the infected count, smoothed because a single epoch of a small outbreak is noisy
+	if (infected_count > 0 && previous_infected_count_ > 0) {
+		double epoch_growth_rate = std::log(static_cast<double>(infected_count) / static_cast<double>(previous_infected_count_));
+		growth_rate_ = GROWTH_RATE_SMOOTHING * epoch_growth_rate + (1.0 - GROWTH_RATE_SMOOTHING) * growth_rate_;
+	}
+	metrics.growth_rate = growth_rate_;
+	metrics.doubling_time = (growth_rate_ > 0.0) ? std::log(2.0) / growth_rate_ : std::numeric_limits<double>::infinity();
+
+	// Renewal equation: infections caused now over the infectiousness of the individuals infected in the previous epochs
+	double infectiousness = static_cast<double>(recent_new_infections_sum_) / static_cast<double>(recent_new_infections_.size());
+	metrics.reproduction_number = (infectiousness > 0.0) ? static_cast<double>(metrics.new_infections) / infectiousness : 0.0;
+
+	// Replace the oldest entry of the ring buffer with the current epoch
+	recent_new_infections_sum_ += metrics.new_infections - recent_new_infections_[recent_index_];
+	recent_new_infections_[recent_index_] = metrics.new_infections;
+	recent_index_ = (recent_index_ + 1) % recent_new_infections_.size();
+
+	previous_hit_count_ = hit_count;
+	previous_infected_count_ = infected_count;
+	++epoch_;
+
+	return metrics;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+// Epidemic metrics of a single epoch
+struct EpochMetrics {
+	int new_infections; // Individuals infected during the epoch
+	int peak_infected_count; // Largest infected count up to and including the epoch
+	int peak_epoch; // Epoch of the largest infected count
+	double growth_rate; // Smoothed exponential growth rate of the infected count, per epoch
+	double doubling_time; // Epochs needed to double the infected count at the current growth rate, infinite when not growing
+	double reproduction_number; // Renewal equation estimate of the instantaneous reproduction number R_t
+};
+
+// EpidemicMetrics updates the epidemic metrics online, in constant time per epoch, from the statistics the simulation already gathers.
+// R_t divides the new infections by the infections of the previous infectious_period epochs, weighted by a uniform generation interval
+class EpidemicMetrics {
+public:
+	EpidemicMetrics(int infectious_period, int initial_infected_count);
+	EpochMetrics advance_epoch(int hit_count, int infected_count);
+private:
+	int epoch_;
+	int previous_hit_count_;
+	int previous_infected_count_;
+	int peak_infected_count_;
+	int peak_epoch_;
+	double growth_rate_;
+	std::vector<int> recent_new_infections_; // Ring buffer with the new infections of the last infectious_period epochs
+	size_t recent_index_; // Oldest entry of the ring buffer
+	long long recent_new_infections_sum_;
+	static const double GROWTH_RATE_SMOOTHING;
+};
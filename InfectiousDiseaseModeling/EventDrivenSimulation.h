@@ -0,0 +1,189 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+
+// Draw the epochs an individual at a location waits before its next move, 0 moves in the current epoch. Every epoch it stays with the
+// stay probability of the location, so the wait is geometric. Returns -1 when it never moves
+inline int draw_dwell_epochs(const NeighborhoodLookupTable& neighborhood_table, const std::vector<float>& stay_probabilities, int location,
+	std::mt19937& random_engine) {
+
+	int degree = neighborhood_table.degree(location);
+	double stay_probability = stay_probabilities.empty() ? 1.0 / (degree + 1) : stay_probabilities[location];
+	if (degree == 0 || stay_probability >= 1.0)
+		return -1;
+	if (stay_probability <= 0.0)
+		return 0;
+	return std::geometric_distribution<int>(1.0 - stay_probability)(random_engine);
+}
+
+// Simulate the population with a compartment model, moving only the individuals whose dwell time at their location ends. Every individual
+// draws its next move epoch when it arrives and waits in a calendar with one bucket per epoch, then moves to a random neighbour, so an epoch
+// costs the moving individuals instead of the population. The occupants of every location are kept in linked lists and the infectious
+// counts of the locations are updated as individuals move and change compartment, so only the locations with infectious individuals are
+// visited for infections, and only the individuals in timed or infectious compartments are advanced.
+// Without stay_probabilities in the options the walk is the one of simulate_compartmental. Also honours the seed, the infectiosity, the venue
+// table, the compartment durations, the epoch observer and the first epoch, but not the layers, interventions, substeps, age groups, contact
+// cap and the multipliers of the population. The run is serial, ensembles parallelise over the runs. Statistics and region statistics are as
+// simulate_compartmental, the region histogram is kept up to date like the statistics instead of being counted every epoch.
+// Throws std::invalid_argument when the stay probabilities are not empty or one chance from 0 to 1 per location
+template <typename Model>
+void simulate_event_driven(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, PopulationState& population,
+	std::vector<std::tuple<int, int, int>>& epoch_statistics, const SimulationOptions& options) {
+
+	int individual_count = population.size();
+	int location_count = neighborhood_table.node_count();
+	if (!options.stay_probabilities.empty() && options.stay_probabilities.size() != static_cast<size_t>(location_count))
+		throw std::invalid_argument("simulate_event_driven: the stay probabilities need one entry per location");
+	for (float stay_probability : options.stay_probabilities)
+		if (!(stay_probability >= 0.0f && stay_probability <= 1.0f))
+			throw std::invalid_argument("simulate_event_driven: every stay probability needs to be between 0 and 1");
+	std::seed_seq seed_sequence = { options.seed, 0u };
+	std::mt19937 random_engine(seed_sequence);
+
+	std::uint8_t durations[COMPARTMENT_COUNT];
+	get_compartment_durations<Model>(options, durations);
+	auto is_tracked = [](std::uint8_t compartment) {
+		return compartment == CompartmentInfectious || Model::RULES[compartment].duration != 0;
+	};
+
+	// Occupants of every location as doubly linked lists through the individuals, the infectious counts and the running statistics
+	std::vector<int> first_occupants(location_count, -1);
+	std::vector<int> next_occupants(individual_count);
+	std::vector<int> previous_occupants(individual_count);
+	std::vector<int> location_infectious_counts(location_count, 0);
+	std::vector<int> tracked_individuals; // Individuals in timed or infectious compartments
+	int hit_count = 0;
+	int infected_count = 0;
+	int recovered_count = 0;
+	int region_count = get_region_count(options, location_count, "simulate_event_driven");
+	const int* location_regions = region_count > 0 ? options.location_regions->data() : nullptr;
+	std::vector<int> running_region_counts(region_count * REGION_STATISTIC_COUNT, 0); // New infections are counted per epoch
+	auto add_occupant = [&](int index, int location) {
+		previous_occupants[index] = -1;
+		next_occupants[index] = first_occupants[location];
+		if (first_occupants[location] != -1)
+			previous_occupants[first_occupants[location]] = index;
+		first_occupants[location] = index;
+	};
+	auto remove_occupant = [&](int index, int location) {
+		if (previous_occupants[index] != -1)
+			next_occupants[previous_occupants[index]] = next_occupants[index];
+		else
+			first_occupants[location] = next_occupants[index];
+		if (next_occupants[index] != -1)
+			previous_occupants[next_occupants[index]] = previous_occupants[index];
+	};
+	auto count_compartment = [&](std::uint8_t compartment, int index, int change) {
+		if (compartment == CompartmentExposed || compartment == CompartmentInfectious)
+			infected_count += change;
+		else if (compartment == CompartmentRecovered)
+			recovered_count += change;
+		if (compartment == CompartmentInfectious)
+			location_infectious_counts[population.locations[index]] += change;
+		if (location_regions)
+			count_region_compartment(&running_region_counts[location_regions[population.locations[index]] * REGION_STATISTIC_COUNT], compartment, change);
+	};
+
+	// Calendar of the moves, one bucket per epoch. Moves after the last epoch are never needed
+	std::vector<std::vector<int>> calendar(total_epochs + 1);
+	auto schedule_move = [&](int index, int current_epoch) {
+		int dwell_epochs = draw_dwell_epochs(neighborhood_table, options.stay_probabilities, population.locations[index], random_engine);
+		if (dwell_epochs >= 0 && dwell_epochs <= total_epochs - current_epoch)
+			calendar[current_epoch + dwell_epochs].push_back(index);
+	};
+
+	for (int index = 0; index < individual_count; ++index) {
+		add_occupant(index, population.locations[index]);
+		count_compartment(population.compartments[index], index, 1);
+		hit_count += population.hit[index];
+		if (is_tracked(population.compartments[index]))
+			tracked_individuals.push_back(index);
+		schedule_move(index, options.first_epoch);
+	}
+
+	float log_escape_chance = std::log(1.0f - options.infectiosity);
+	const float* rate_multipliers = get_rate_multipliers(options, location_count, "simulate_event_driven");
+	std::vector<int> location_visits(location_count, -1); // Last epoch every location was visited by the infection pass
+	std::vector<int> infections;
+	std::uniform_real_distribution<float> real_random(0.0f, 1.0f);
+	epoch_statistics.clear();
+
+	// Repeat for all the epochs
+	for (int current_epoch = options.first_epoch; current_epoch < (total_epochs + 1); ++current_epoch) {
+
+		// Move the individuals of the bucket to a random neighbour, they wait there for their next move.
+		// Staying is part of the dwell time, so every move changes the location
+		for (int index : calendar[current_epoch]) {
+			int location = population.locations[index];
+			int target = neighborhood_table.neighbours_begin(location)[std::uniform_int_distribution<int>(0, neighborhood_table.degree(location) - 1)(random_engine)];
+			remove_occupant(index, location);
+			add_occupant(index, target);
+			if (population.compartments[index] == CompartmentInfectious) {
+				--location_infectious_counts[location];
+				++location_infectious_counts[target];
+			}
+			if (location_regions && location_regions[location] != location_regions[target]) {
+				count_region_compartment(&running_region_counts[location_regions[location] * REGION_STATISTIC_COUNT], population.compartments[index], -1);
+				count_region_compartment(&running_region_counts[location_regions[target] * REGION_STATISTIC_COUNT], population.compartments[index], 1);
+			}
+			population.locations[index] = target;
+			schedule_move(index, current_epoch + 1);
+		}
+		std::vector<int>().swap(calendar[current_epoch]);
+
+		// Infect the susceptible occupants of the locations with infectious individuals, the infections take effect after the pass
+		infections.clear();
+		for (int infectious_index : tracked_individuals) {
+			int location = population.locations[infectious_index];
+			if (population.compartments[infectious_index] != CompartmentInfectious || location_visits[location] == current_epoch)
+				continue;
+			location_visits[location] = current_epoch;
+
+			float infection_chance = 1.0f - std::exp(log_escape_chance * (rate_multipliers ? rate_multipliers[location] : 1.0f) * location_infectious_counts[location]);
+			for (int index = first_occupants[location]; index != -1; index = next_occupants[index])
+				if (population.compartments[index] == CompartmentSusceptible && real_random(random_engine) < infection_chance)
+					infections.push_back(index);
+		}
+		for (int index : infections) {
+			count_compartment(CompartmentSusceptible, index, -1);
+			population.compartments[index] = Model::RULES[CompartmentSusceptible].next;
+			population.timers[index] = 0;
+			count_compartment(population.compartments[index], index, 1);
+			hit_count += population.hit[index] ? 0 : 1;
+			population.hit[index] = 1;
+			if (!is_tracked(CompartmentSusceptible) && is_tracked(population.compartments[index]))
+				tracked_individuals.push_back(index);
+			if (location_regions)
+				++running_region_counts[location_regions[population.locations[index]] * REGION_STATISTIC_COUNT + RegionNewInfections];
+		}
+
+		// Advance the tracked individuals, the ones leaving the tracked compartments drop out of the list
+		int kept_count = 0;
+		for (int index : tracked_individuals) {
+			std::uint8_t compartment = population.compartments[index];
+			advance_individual<Model>(population.compartments[index], population.timers[index], durations, random_engine);
+			if (population.compartments[index] != compartment) {
+				count_compartment(compartment, index, -1);
+				count_compartment(population.compartments[index], index, 1);
+			}
+			if (is_tracked(population.compartments[index]))
+				tracked_individuals[kept_count++] = index;
+		}
+		tracked_individuals.resize(kept_count);
+
+		if (location_regions) {
+			int* region_counts = add_region_counts(options);
+			std::copy(running_region_counts.begin(), running_region_counts.end(), region_counts);
+			for (int region = 0; region < region_count; ++region)
+				running_region_counts[region * REGION_STATISTIC_COUNT + RegionNewInfections] = 0;
+		}
+		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count));
+		if (options.epoch_observer && !options.epoch_observer(current_epoch, epoch_statistics.back()))
+			break;
+	}
+}
\ No newline at end of file
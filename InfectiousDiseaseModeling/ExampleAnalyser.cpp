@@ -0,0 +1,32 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "Analyser.h"
+
+// Example analyser plugin: reports the most crowded location and the location with the most infected individuals of every epoch.
+// Build it with "make exampleanalyser" and list ./exampleanalyser.so in ANALYSER_PLUGIN_PATHS
+class HotspotAnalyser : public Analyser {
+public:
+	void analyse(const PopulationView& population, const LocationGraphView& location_graph) override {
+
+		occupant_counts_.assign(location_graph.location_count, 0);
+		infected_counts_.assign(location_graph.location_count, 0);
+		for (int index = 0; index < population.individual_count; ++index) {
+			++occupant_counts_[population.locations[index]];
+			if (population.states[index] == AnalyserInfected)
+				++infected_counts_[population.locations[index]];
+		}
+
+		std::vector<int>::const_iterator most_crowded = std::max_element(occupant_counts_.begin(), occupant_counts_.end());
+		std::vector<int>::const_iterator most_infected = std::max_element(infected_counts_.begin(), infected_counts_.end());
+		std::cout << "Epoch " << population.epoch << " most crowded location: " << (most_crowded - occupant_counts_.begin()) << " (" << *most_crowded
+			<< ") most infected location: " << (most_infected - infected_counts_.begin()) << " (" << *most_infected << ")" << std::endl;
+	}
+private:
+	std::vector<int> occupant_counts_;
+	std::vector<int> infected_counts_;
+};
+
+extern "C" Analyser* create_analyser() {
+	return new HotspotAnalyser();
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include "FrameWriter.h"
+
+// Start the file with the header and the node permutation. Fails without creating the file when the largest possible frame
+// (bit packed, the run length encoding is only used when smaller) does not fit in the burst, every frame would be skipped
+bool FrameWriter::open(const std::string& filename, const NeighborhoodLookupTable& neighborhood_table, size_t bytes_per_epoch) {
+
+	if (get_max_frame_size(neighborhood_table.node_count()) > bytes_per_epoch * BURST_EPOCHS || !file_writer_.open(filename))
+		return false;
+
+	permutation_ = get_breadth_first_permutation(neighborhood_table);
+	bytes_per_epoch_ = bytes_per_epoch;
+	available_bytes_ = bytes_per_epoch * BURST_EPOCHS;
+	written_frame_count_ = 0;
+	skipped_frame_count_ = 0;
+
+	std::vector<char> file_header = { 'D', 'M', 'F', 'R' };
+	append_uint32(file_header, 1); // Version
+	append_uint32(file_header, static_cast<std::uint32_t>(permutation_.size()));
+	append_uint32(file_header, 2); // Bits per class
+	for (int location : permutation_)
+		append_uint32(file_header, static_cast<std::uint32_t>(location));
+	file_writer_.write(std::move(file_header)); // The header is not charged to the bandwidth budget
+
+	return true;
+}
+
+// Encode the classes of one epoch with the smaller of the two encodings and queue the frame, unless the budget is exhausted
+bool FrameWriter::write_frame(int epoch, const std::vector<std::uint8_t>& prevalence_classes) {
+
+	available_bytes_ = std::min(available_bytes_ + bytes_per_epoch_, bytes_per_epoch_ * BURST_EPOCHS);
+
+	// Bit packed encoding, 4 classes per byte
+	packed_payload_.assign((permutation_.size() + 3) / 4, 0);
+	for (size_t position = 0; position != permutation_.size(); ++position)
+		packed_payload_[position >> 2] |= static_cast<char>((prevalence_classes[permutation_[position]] & 3) << ((position & 3) * 2));
+
+	// Run length encoding, runs end at a class change
+	run_length_payload_.clear();
+	for (size_t run_start = 0; run_start != permutation_.size(); ) {
+		std::uint8_t run_class = prevalence_classes[permutation_[run_start]];
+		size_t run_end = run_start + 1;
+		while (run_end != permutation_.size() && prevalence_classes[permutation_[run_end]] == run_class)
+			++run_end;
+
+		run_length_payload_.push_back(static_cast<char>(run_class));
+		for (size_t run_length = run_end - run_start; ; run_length >>= 7) {
+			if (run_length < 0x80) {
+				run_length_payload_.push_back(static_cast<char>(run_length));
+				break;
+			}
+			run_length_payload_.push_back(static_cast<char>((run_length & 0x7F) | 0x80));
+		}
+		run_start = run_end;
+	}
+
+	bool run_length_encoded = run_length_payload_.size() < packed_payload_.size();
+	const std::vector<char>& payload = run_length_encoded ? run_length_payload_ : packed_payload_;
+
+	size_t frame_size = 12 + payload.size();
+	if (frame_size > available_bytes_) {
+		++skipped_frame_count_;
+		return false;
+	}
+	available_bytes_ -= frame_size;
+
+	std::vector<char> frame;
+	frame.reserve(frame_size);
+	append_uint32(frame, static_cast<std::uint32_t>(epoch));
+	frame.push_back(run_length_encoded ? 1 : 0);
+	frame.insert(frame.end(), 3, 0); // Padding
+	append_uint32(frame, static_cast<std::uint32_t>(payload.size()));
+	frame.insert(frame.end(), payload.begin(), payload.end());
+	file_writer_.write(std::move(frame));
+
+	++written_frame_count_;
+	return true;
+}
+
+// Wait for the queued frames and close the file
+void FrameWriter::close() {
+	file_writer_.close();
+}
+
+// Order the locations breadth first, starting a new search from the lowest unvisited location of every connected component
+std::vector<int> FrameWriter::get_breadth_first_permutation(const NeighborhoodLookupTable& neighborhood_table) {
+
+	int location_count = neighborhood_table.node_count();
+	std::vector<int> permutation;
+	permutation.reserve(location_count);
+	std::vector<bool> visited(location_count, false);
+
+	for (int root = 0; root < location_count; ++root) {
+		if (visited[root])
+			continue;
+		visited[root] = true;
+
+		// The permutation itself is the queue of the search
+		size_t frontier_index = permutation.size();
+		permutation.push_back(root);
+		for (; frontier_index != permutation.size(); ++frontier_index) {
+			int location = permutation[frontier_index];
+			for (const int* neighbour = neighborhood_table.neighbours_begin(location); neighbour != neighborhood_table.neighbours_end(location); ++neighbour) {
+				if (!visited[*neighbour]) {
+					visited[*neighbour] = true;
+					permutation.push_back(*neighbour);
+				}
+			}
+		}
+	}
+	return permutation;
+}
+
+// Append a little endian 32 bit integer
+void FrameWriter::append_uint32(std::vector<char>& buffer, std::uint32_t value) {
+	for (int byte_index = 0; byte_index != 4; ++byte_index)
+		buffer.push_back(static_cast<char>((value >> (8 * byte_index)) & 0xFF));
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AsyncFileWriter.h"
+#include "NeighborhoodLookupTable.h"
+
+// FrameWriter writes the prevalence class of every location, once per epoch, into a compact binary file through an AsyncFileWriter.
+// File layout, all integers little endian:
+//   file header   "DMFR", uint32 version, uint32 node_count, uint32 bits_per_class (2),
+//                 node_count x uint32 permutation: frame position -> location node
+//   frame         uint32 epoch, uint8 encoding, 3 bytes padding, uint32 payload_size, payload
+//   encoding 0    classes in permutation order, 2 bits each, the first class in the lowest bits of the first byte
+//   encoding 1    run length encoded classes in permutation order: uint8 class followed by the run length as a LEB128 varint
+// The permutation is a breadth first order of the location graph, so neighbouring locations share runs.
+// Frames are skipped whenever writing them would exceed the bandwidth budget of bytes_per_epoch (with a burst of a few epochs),
+// a budget whose burst cannot hold the largest frame is rejected by open
+class FrameWriter {
+public:
+	FrameWriter() : bytes_per_epoch_(0), available_bytes_(0), written_frame_count_(0), skipped_frame_count_(0) { } // Default constructor
+	bool open(const std::string& filename, const NeighborhoodLookupTable& neighborhood_table, size_t bytes_per_epoch);
+	bool write_frame(int epoch, const std::vector<std::uint8_t>& prevalence_classes);
+	void close();
+	bool is_open() const;
+	static size_t get_max_frame_size(int node_count);
+	int get_written_frame_count() const;
+	int get_skipped_frame_count() const;
+private:
+	AsyncFileWriter file_writer_;
+	std::vector<int> permutation_;
+	size_t bytes_per_epoch_;
+	size_t available_bytes_; // Token bucket of the bandwidth budget
+	int written_frame_count_;
+	int skipped_frame_count_;
+	std::vector<char> packed_payload_; // Reused encoding buffers
+	std::vector<char> run_length_payload_;
+	static const size_t BURST_EPOCHS = 4;
+	static std::vector<int> get_breadth_first_permutation(const NeighborhoodLookupTable& neighborhood_table);
+	static void append_uint32(std::vector<char>& buffer, std::uint32_t value);
+};
+
+// Check if frames are being written
+inline bool FrameWriter::is_open() const {
+	return file_writer_.is_open();
+}
+
+// Get the size of the largest frame of a graph: the frame header and the bit packed classes
+inline size_t FrameWriter::get_max_frame_size(int node_count) {
+	return 12 + (static_cast<size_t>(node_count) + 3) / 4;
+}
+
+// Get the number of frames written so far
+inline int FrameWriter::get_written_frame_count() const {
+	return written_frame_count_;
+}
+
+// Get the number of frames skipped to stay within the bandwidth budget
+inline int FrameWriter::get_skipped_frame_count() const {
+	return skipped_frame_count_;
+}
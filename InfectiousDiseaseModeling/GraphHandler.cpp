@@ -1,7 +1,11 @@
 #include <random>
 #include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
 #include <boost/tokenizer.hpp>
-#include <boost/graph/graphviz.hpp>
 #include "Settings.h"
 #include "GraphHandler.h"
 
@@ -49,6 +53,29 @@ std::vector<std::vector<int>> GraphHandler::get_node_neighborhood_lookup_vector(
 	return returning_neighborhood_lookup_map;
 }
 
+// Scan the location graph and return a compressed sparse row table that binds every location with its neighbouring locations
+NeighborhoodLookupTable GraphHandler::get_node_neighborhood_lookup_table(const LocationUndirectedGraph& location_graph) {
+
+	NeighborhoodLookupTable neighborhood_table;
+	int location_count = static_cast<int>(num_vertices(location_graph));
+
+	// First pass: the offset of every node is the running sum of the degrees of the previous nodes
+	neighborhood_table.offsets.resize(location_count + 1, 0);
+	for (int location = 0; location < location_count; ++location)
+		neighborhood_table.offsets[location + 1] = neighborhood_table.offsets[location] + static_cast<int>(out_degree(location, location_graph));
+
+	// Second pass: copy the neighbours of every node into its row
+	neighborhood_table.neighbours.reserve(neighborhood_table.offsets[location_count]);
+	LocationUndirectedGraph::adjacency_iterator neighbour_iterator_start, neighbour_iterator_end; // Neighbouring node iterators
+	for (int location = 0; location < location_count; ++location) {
+		tie(neighbour_iterator_start, neighbour_iterator_end) = adjacent_vertices(location, location_graph); // Tie adjacent/neighbouring location nodes
+		for (; neighbour_iterator_start != neighbour_iterator_end; ++neighbour_iterator_start)
+			neighborhood_table.neighbours.push_back(static_cast<int>(*neighbour_iterator_start)); // Add the current neighbour
+	}
+
+	return neighborhood_table;
+}
+
 // Generate a vector of individuals and assign a random location within the requested ranges
 std::vector<Individual> GraphHandler::get_random_individuals(int individual_count, int location_count) {
 
@@ -58,7 +85,7 @@ std::vector<Individual> GraphHandler::get_random_individuals(int individual_coun
 	// Randomly assign locations to individuals in the population	
 	std::random_device random_device;
 	std::mt19937 mersenne_twister_engine(random_device());
-	std::uniform_int_distribution<> uniform_int_distribution(0, location_count);
+	std::uniform_int_distribution<> uniform_int_distribution(0, location_count - 1); // Bounds are inclusive, location_count is not a valid node
 
 	for (Individual& current_individual : individuals) {
 		current_individual.set_location(uniform_int_distribution(mersenne_twister_engine)); // Assign the random location
@@ -69,6 +96,14 @@ std::vector<Individual> GraphHandler::get_random_individuals(int individual_coun
 // Read the openstream map edges file and generate a Undirected graph of locations
 LocationUndirectedGraph GraphHandler::get_location_undirected_graph_from_file(std::string filename) {
 
+	boost::unordered_map<size_t, int> map_location_to_index;
+	return get_location_undirected_graph_from_file(filename, map_location_to_index);
+}
+
+// Read the openstream map edges file and generate a Undirected graph of locations. The map binds the openstreet map node ids to graph nodes;
+// ids already in the map keep their graph node, so several files can share one set of nodes
+LocationUndirectedGraph GraphHandler::get_location_undirected_graph_from_file(std::string filename, boost::unordered_map<size_t, int>& map_location_to_index) {
+
 	using namespace std;
 	using namespace boost;
 
@@ -87,8 +122,7 @@ LocationUndirectedGraph GraphHandler::get_location_undirected_graph_from_file(st
 	// We use size_t because the input file has values much larger than uint32_t for each location
 	// and int for the second part of the map because the distinct location count is small and the boost:undirected graph
 	// accepts location indices of type int
-	boost::unordered_map<size_t, int> map_location_to_index;
-	int current_location_index = 0;
+	int current_location_index = static_cast<int>(map_location_to_index.size());
 
 	while (getline(input_file_stream, current_line)) {
 		Tokenizer tok(current_line);
@@ -117,6 +151,203 @@ LocationUndirectedGraph GraphHandler::get_location_undirected_graph_from_file(st
 	return location_graph;
 }
 
+// Read one edges file per movement layer into neighbourhood tables over the same locations. Locations that are missing from a layer
+// (or only appear in the map) are isolated nodes of it, so every table has one row per location in the map
+std::vector<NeighborhoodLookupTable> GraphHandler::get_location_layer_tables_from_files(const std::vector<std::string>& filenames,
+	boost::unordered_map<size_t, int>& map_location_to_index) {
+
+	std::vector<LocationUndirectedGraph> layer_graphs;
+	for (const std::string& filename : filenames)
+		layer_graphs.push_back(get_location_undirected_graph_from_file(filename, map_location_to_index));
+
+	std::vector<NeighborhoodLookupTable> layer_tables;
+	for (LocationUndirectedGraph& layer_graph : layer_graphs) {
+		while (num_vertices(layer_graph) < map_location_to_index.size())
+			add_vertex(layer_graph);
+		layer_tables.push_back(get_node_neighborhood_lookup_table(layer_graph));
+	}
+
+	return layer_tables;
+}
+
+// Parse a whole field as an integer, surrounding blanks allowed. Returns false for anything else, including out of range numbers
+bool GraphHandler::parse_int(const std::string& field, int& value) {
+	size_t parsed_length = 0;
+	try {
+		value = std::stoi(field, &parsed_length);
+	}
+	catch (const std::logic_error&) {
+		return false;
+	}
+	return field.find_first_not_of(" \t\r", parsed_length) == std::string::npos;
+}
+
+// Parse a whole field as a float, surrounding blanks allowed. Returns false for anything else, including out of range numbers
+bool GraphHandler::parse_float(const std::string& field, float& value) {
+	size_t parsed_length = 0;
+	try {
+		value = std::stof(field, &parsed_length);
+	}
+	catch (const std::logic_error&) {
+		return false;
+	}
+	return field.find_first_not_of(" \t\r", parsed_length) == std::string::npos;
+}
+
+// Parse a whole field as an openstreet map node id, surrounding blanks allowed. Returns false for anything else, including signs
+bool GraphHandler::parse_node_id(const std::string& field, size_t& value) {
+	size_t first = field.find_first_not_of(" \t");
+	if (first == std::string::npos || !std::isdigit(static_cast<unsigned char>(field[first])))
+		return false; // std::stoull would wrap negative numbers around
+	size_t parsed_length = 0;
+	try {
+		value = static_cast<size_t>(std::stoull(field, &parsed_length));
+	}
+	catch (const std::logic_error&) {
+		return false;
+	}
+	return field.find_first_not_of(" \t\r", parsed_length) == std::string::npos;
+}
+
+// Get the error for a line of an input file that does not hold what was expected
+std::invalid_argument GraphHandler::get_line_error(const std::string& filename, int line_number, const std::string& expected, const std::string& line) {
+	return std::invalid_argument(filename + ":" + std::to_string(line_number) + ": expected " + expected + ", got \"" + line + "\"");
+}
+
+// Read a region mapping file with one "openstreet map node id,region" line per location and return the region of every graph node.
+// Regions are numbered from 0; locations missing from the file get the extra region region_count - 1.
+// Throws std::invalid_argument naming the line when a line is not a node id and a region
+std::vector<int> GraphHandler::get_location_regions_from_file(std::string filename, const boost::unordered_map<size_t, int>& map_location_to_index,
+	int location_count, int& region_count) {
+
+	typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer; // boost tokenizer parses comma separated values
+
+	std::vector<int> location_regions(location_count, -1);
+	int max_region = -1;
+
+	std::ifstream input_file_stream(filename);
+	std::vector<std::string> string_vector;
+	std::string current_line;
+	int line_number = 0;
+
+	while (getline(input_file_stream, current_line)) {
+		++line_number;
+		if (current_line.empty())
+			continue;
+
+		Tokenizer tok(current_line);
+		string_vector.assign(tok.begin(), tok.end());
+		size_t node_id;
+		int region;
+		if (string_vector.size() < 2 || !parse_node_id(string_vector[0], node_id) || !parse_int(string_vector[1], region) || region < 0)
+			throw get_line_error(filename, line_number, "\"openstreet map node id,region\"", current_line);
+
+		boost::unordered_map<size_t, int>::const_iterator location = map_location_to_index.find(node_id);
+		if (location == map_location_to_index.end() || location->second >= location_count)
+			continue; // Node is not part of the graph
+
+		location_regions[location->second] = region;
+		max_region = std::max(max_region, region);
+	}
+
+	region_count = max_region + 2; // One more for the unassigned locations
+	for (int& location_region : location_regions)
+		if (location_region < 0)
+			location_region = region_count - 1;
+
+	return location_regions;
+}
+
+// Read the venue attributes file with one "openstreet map node id,rate multiplier,capacity,type" line per venue, the type is a VenueType number.
+// Locations without a line keep the defaults of VenueTable::assign_defaults.
+// Throws std::invalid_argument naming the line when a line is not a node id, a non-negative multiplier and capacity and a venue type
+VenueTable GraphHandler::get_venue_table_from_file(std::string filename, const boost::unordered_map<size_t, int>& map_location_to_index, int location_count) {
+
+	typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer; // boost tokenizer parses comma separated values
+
+	VenueTable venue_table;
+	venue_table.assign_defaults(location_count);
+
+	std::ifstream input_file_stream(filename);
+	std::vector<std::string> string_vector;
+	std::string current_line;
+	int line_number = 0;
+
+	while (getline(input_file_stream, current_line)) {
+		++line_number;
+		if (current_line.empty())
+			continue;
+
+		Tokenizer tok(current_line);
+		string_vector.assign(tok.begin(), tok.end());
+		size_t node_id;
+		float rate_multiplier;
+		int capacity;
+		int type;
+		if (string_vector.size() < 4 || !parse_node_id(string_vector[0], node_id)
+			|| !parse_float(string_vector[1], rate_multiplier) || !std::isfinite(rate_multiplier) || rate_multiplier < 0.0f
+			|| !parse_int(string_vector[2], capacity) || capacity < 0
+			|| !parse_int(string_vector[3], type) || type < VenueResidential || type > VenueOther)
+			throw get_line_error(filename, line_number, "\"openstreet map node id,rate multiplier,capacity,type\"", current_line);
+
+		boost::unordered_map<size_t, int>::const_iterator location = map_location_to_index.find(node_id);
+		if (location == map_location_to_index.end() || location->second >= location_count)
+			continue; // Node is not part of the graph
+
+		venue_table.rate_multipliers[location->second] = rate_multiplier;
+		venue_table.capacities[location->second] = capacity;
+		venue_table.types[location->second] = static_cast<std::uint8_t>(type);
+	}
+
+	return venue_table;
+}
+
+// Read the observed cumulative case counts, one line per epoch starting at epoch 0.
+// Throws std::invalid_argument naming the line when a line is not a count
+std::vector<int> GraphHandler::get_case_curve_from_file(std::string filename) {
+
+	std::vector<int> case_curve;
+	std::ifstream input_file_stream(filename);
+	std::string current_line;
+	int line_number = 0;
+
+	while (getline(input_file_stream, current_line)) {
+		++line_number;
+		if (current_line.empty())
+			continue;
+
+		int case_count;
+		if (!parse_int(current_line, case_count) || case_count < 0)
+			throw get_line_error(filename, line_number, "a case count", current_line);
+		case_curve.push_back(case_count);
+	}
+
+	return case_curve;
+}
+
+// Read the calibration proposals, one infectiosity per line.
+// Throws std::invalid_argument naming the line when a line is not an infectiosity in [0, 1)
+std::vector<float> GraphHandler::get_proposals_from_file(std::string filename) {
+
+	std::vector<float> proposals;
+	std::ifstream input_file_stream(filename);
+	std::string current_line;
+	int line_number = 0;
+
+	while (getline(input_file_stream, current_line)) {
+		++line_number;
+		if (current_line.empty())
+			continue;
+
+		float infectiosity;
+		if (!parse_float(current_line, infectiosity) || !(infectiosity >= 0.0f && infectiosity < 1.0f))
+			throw get_line_error(filename, line_number, "an infectiosity in [0, 1)", current_line);
+		proposals.push_back(infectiosity);
+	}
+
+	return proposals;
+}
+
 // Generate a sample location undirected graph, similar to the one given in the python toy example
 LocationUndirectedGraph GraphHandler::get_sample_location_undirected_graph() {
 
@@ -146,62 +377,233 @@ LocationUndirectedGraph GraphHandler::get_sample_location_undirected_graph() {
 	return location_graph;
 }
 
-// Save an Undirected location graph into a graphiz dot file, to disk
+// Save an Undirected location graph into a graphiz dot file, to disk. Nodes and edges are streamed straight to the file
 void GraphHandler::save_undirected_graph_to_graphviz_file(std::string filename, const LocationUndirectedGraph& location_graph) {
 
-	std::vector<std::string> NameVec(location_graph.m_vertices.size(), "Location"); // Name of the node
-	
 	std::ofstream dotfile(filename.c_str());
-	boost::write_graphviz(dotfile, location_graph,
-		boost::make_label_writer(&NameVec[0])
-		);
+	dotfile << "graph G {\n";
+
+	int location_count = static_cast<int>(num_vertices(location_graph));
+	for (int location = 0; location < location_count; ++location)
+		dotfile << location << "[label=Location];\n";
+
+	LocationUndirectedGraph::edge_iterator edge_iterator_start, edge_iterator_end; // Location edge iterators
+	for (std::tie(edge_iterator_start, edge_iterator_end) = edges(location_graph); edge_iterator_start != edge_iterator_end; ++edge_iterator_start)
+		dotfile << source(*edge_iterator_start, location_graph) << "--" << target(*edge_iterator_start, location_graph) << " ;\n";
 
+	dotfile << "}\n";
 	dotfile.close();
 }
 
-// Save the hit and infected counts for each epoch into a csv file, to disk
-void GraphHandler::save_epoch_statistics_to_csv(std::string filename, const std::vector<std::tuple<int, int, int>>& epoch_statistics){
+// Save the location graph coloured by the current infection prevalence into a graphviz dot file, to disk.
+// When hotspot_count is positive only the hop_count neighbourhood of the hotspot_count locations with the most infected individuals is written
+void GraphHandler::save_prevalence_graph_to_graphviz_file(std::string filename, const NeighborhoodLookupTable& neighborhood_table,
+	const std::vector<Individual>& individuals, int hotspot_count, int hop_count) {
+
+	static const char* const prevalence_colours[] = { "white", "palegreen", "orange", "red" }; // Indexed by PrevalenceClass
+
+	int location_count = neighborhood_table.node_count();
+	std::vector<int> occupant_counts, infected_counts;
+	count_location_occupants(location_count, individuals, occupant_counts, infected_counts);
+
+	// Hop distance of every written location from the closest hotspot, -1 for locations that are not written
+	std::vector<int> hop_distances(location_count, hotspot_count > 0 ? -1 : 0);
+
+	if (hotspot_count > 0) {
+		std::vector<int> hotspots;
+		for (int location = 0; location < location_count; ++location)
+			if (infected_counts[location] > 0)
+				hotspots.push_back(location);
+
+		// Keep the locations with the most infected individuals
+		if (static_cast<int>(hotspots.size()) > hotspot_count) {
+			std::partial_sort(hotspots.begin(), hotspots.begin() + hotspot_count, hotspots.end(),
+				[&infected_counts](int first, int second) { return infected_counts[first] > infected_counts[second]; });
+			hotspots.resize(hotspot_count);
+		}
+
+		// Breadth first search from all the hotspots at once, the frontier of each hop is appended after the previous one
+		std::vector<int> frontier(hotspots);
+		for (int hotspot : hotspots)
+			hop_distances[hotspot] = 0;
+		for (size_t frontier_index = 0; frontier_index != frontier.size(); ++frontier_index) {
+			int location = frontier[frontier_index];
+			if (hop_distances[location] == hop_count)
+				continue;
+			for (const int* neighbour = neighborhood_table.neighbours_begin(location); neighbour != neighborhood_table.neighbours_end(location); ++neighbour) {
+				if (hop_distances[*neighbour] < 0) {
+					hop_distances[*neighbour] = hop_distances[location] + 1;
+					frontier.push_back(*neighbour);
+				}
+			}
+		}
+	}
+
+	std::ofstream dotfile(filename.c_str());
+	dotfile << "graph G {\nnode [style=filled, label=\"\"];\n";
+
+	for (int location = 0; location < location_count; ++location)
+		if (hop_distances[location] >= 0)
+			dotfile << location << " [fillcolor=" << prevalence_colours[get_prevalence_class(occupant_counts[location], infected_counts[location])] << "];\n";
+
+	// Every undirected edge appears in the rows of both of its nodes, write it once from the lower node
+	for (int location = 0; location < location_count; ++location) {
+		if (hop_distances[location] < 0)
+			continue;
+		for (const int* neighbour = neighborhood_table.neighbours_begin(location); neighbour != neighborhood_table.neighbours_end(location); ++neighbour)
+			if (*neighbour > location && hop_distances[*neighbour] >= 0)
+				dotfile << location << "--" << *neighbour << ";\n";
+	}
+
+	dotfile << "}\n";
+	dotfile.close();
+}
+
+// Get the prevalence class of every location
+std::vector<std::uint8_t> GraphHandler::get_location_prevalence_classes(int location_count, const std::vector<Individual>& individuals) {
+
+	std::vector<int> occupant_counts, infected_counts;
+	count_location_occupants(location_count, individuals, occupant_counts, infected_counts);
+
+	std::vector<std::uint8_t> prevalence_classes(location_count);
+	for (int location = 0; location < location_count; ++location)
+		prevalence_classes[location] = get_prevalence_class(occupant_counts[location], infected_counts[location]);
+
+	return prevalence_classes;
+}
+
+// Get the number of infected individuals at every location
+std::vector<int> GraphHandler::get_location_infected_counts(int location_count, const std::vector<Individual>& individuals) {
+
+	std::vector<int> infected_counts(location_count, 0);
+	for (const Individual& current_individual : individuals)
+		if (current_individual.is_infected())
+			++infected_counts[current_individual.get_location()];
+
+	return infected_counts;
+}
+
+// Count the individuals and the infected individuals at every location
+void GraphHandler::count_location_occupants(int location_count, const std::vector<Individual>& individuals,
+	std::vector<int>& occupant_counts, std::vector<int>& infected_counts) {
+
+	occupant_counts.assign(location_count, 0);
+	infected_counts.assign(location_count, 0);
+
+	for (const Individual& current_individual : individuals) {
+		++occupant_counts[current_individual.get_location()];
+		if (current_individual.is_infected())
+			++infected_counts[current_individual.get_location()];
+	}
+}
+
+// Save the hit and infected counts and the epidemic metrics for each epoch into a csv file, to disk. region_statistics adds the susceptible,
+// infected, recovered and new infection counts of every region as columns, REGION_STATISTIC_COUNT counts per region per epoch, epoch major
+void GraphHandler::save_epoch_statistics_to_csv(std::string filename, const std::vector<std::tuple<int, int, int>>& epoch_statistics,
+	const std::vector<EpochMetrics>& epoch_metrics, int region_count, const std::vector<int>& region_statistics) {
 
 	std::ofstream output_csv;
 	output_csv.open(std::string(filename));
 
 	// Write columns
-	output_csv << "epoch,hitcount,infectedcount,recoveredcount" << std::endl;
+	output_csv << "epoch,hitcount,infectedcount,recoveredcount,newinfections,peakinfectedcount,peakepoch,growthrate,doublingtime,reproductionnumber";
+	for (int region = 0; region < region_count; ++region)
+		output_csv << ",region" << region << "susceptiblecount,region" << region << "infectedcount,region" << region << "recoveredcount,region"
+			<< region << "newinfections";
+	output_csv << std::endl;
 	
 	// Write a line for each epoch
-	for (int epoch_index = 0; epoch_index != epoch_statistics.size(); ++epoch_index)
+	size_t region_row_length = static_cast<size_t>(region_count) * REGION_STATISTIC_COUNT;
+	for (size_t epoch_index = 0; epoch_index != epoch_statistics.size(); ++epoch_index) {
+		const EpochMetrics& metrics = epoch_metrics[epoch_index];
 		output_csv << epoch_index << "," << get<0>(epoch_statistics[epoch_index]) << "," << get<1>(epoch_statistics[epoch_index])
-			<< "," << get<2>(epoch_statistics[epoch_index]) << std::endl;
+			<< "," << get<2>(epoch_statistics[epoch_index]) << "," << metrics.new_infections << "," << metrics.peak_infected_count
+			<< "," << metrics.peak_epoch << "," << metrics.growth_rate << "," << metrics.doubling_time << "," << metrics.reproduction_number;
+		for (size_t count_index = 0; count_index < region_row_length && (epoch_index + 1) * region_row_length <= region_statistics.size(); ++count_index)
+			output_csv << "," << region_statistics[epoch_index * region_row_length + count_index];
+		output_csv << std::endl;
+	}
 
 	output_csv.close();
 }
 
-// Show the Hit percentage (fraction of the total population that got infected), epidemic peak percentage and the epoch of the epidemic peak
-void GraphHandler::show_epidemic_results(int population_count, const std::vector<std::tuple<int, int, int>>& epoch_statistics) {
+// Save the location and state (0 susceptible, 1 infected, 2 recovered) of every cohort member for each epoch into a csv file, to disk
+void GraphHandler::save_cohort_trajectories_to_csv(std::string filename, const std::vector<int>& cohort, const std::vector<int>& locations,
+	const std::vector<std::uint8_t>& states) {
+
+	std::ofstream output_csv;
+	output_csv.open(std::string(filename));
+
+	// Write columns
+	output_csv << "epoch,individual,location,state" << std::endl;
+
+	// Write a line for each cohort member of each epoch
+	for (size_t entry_index = 0; entry_index != locations.size(); ++entry_index)
+		output_csv << entry_index / cohort.size() << "," << cohort[entry_index % cohort.size()] << "," << locations[entry_index]
+			<< "," << static_cast<int>(states[entry_index]) << "\n";
+
+	output_csv.close();
+}
+
+// Save the statistics of every sweep point, with the parameters of the point on every line, into one csv file, to disk
+void GraphHandler::save_sweep_statistics_to_csv(std::string filename, const std::vector<SweepPoint>& sweep_points,
+	const std::vector<std::vector<std::tuple<int, int, int>>>& point_statistics) {
+
+	std::ofstream output_csv;
+	output_csv.open(std::string(filename));
+
+	// Write columns
+	output_csv << "point,infectiosity,disease_duration,initial_infected_count,replicate,epoch,hit,infected,recovered" << std::endl;
+
+	// Write a line for each epoch of each point
+	for (size_t point_index = 0; point_index != sweep_points.size(); ++point_index) {
+		const SweepPoint& sweep_point = sweep_points[point_index];
+		for (size_t epoch_index = 0; epoch_index != point_statistics[point_index].size(); ++epoch_index) {
+			const std::tuple<int, int, int>& statistics = point_statistics[point_index][epoch_index];
+			output_csv << point_index << "," << sweep_point.infectiosity << "," << static_cast<int>(sweep_point.disease_duration) << ","
+				<< sweep_point.initial_infected_count << "," << sweep_point.replicate << "," << epoch_index << "," << get<0>(statistics) << "," << get<1>(statistics) << "," << get<2>(statistics) << "\n";
+		}
+	}
+
+	output_csv.close();
+}
+
+// Save the calibration samples into a csv file, to disk
+void GraphHandler::save_calibration_samples_to_csv(std::string filename, const std::vector<CalibrationSample>& samples) {
+
+	std::ofstream output_csv;
+	output_csv.open(std::string(filename));
+
+	// Write columns
+	output_csv << "infectiosity,distance,epoch_count,accepted" << std::endl;
+
+	// Write a line for each sample
+	for (const CalibrationSample& sample : samples)
+		output_csv << sample.infectiosity << "," << sample.distance << "," << sample.epoch_count << "," << (sample.accepted ? 1 : 0) << "\n";
+
+	output_csv.close();
+}
+
+// Show the Hit percentage (fraction of the total population that got infected), epidemic peak percentage and the epoch of the epidemic peak.
+// The peak is tracked online by the simulation, so only the metrics of the last epoch are needed
+void GraphHandler::show_epidemic_results(int population_count, const std::vector<std::tuple<int, int, int>>& epoch_statistics,
+	const std::vector<EpochMetrics>& epoch_metrics) {
 	
 	// Fraction of the population that got infected
 	int hit_count = get<0>(epoch_statistics[epoch_statistics.size() - 1]);
 	int infected_count = get<1>(epoch_statistics[epoch_statistics.size() - 1]);
 	int recovered_count = get<2>(epoch_statistics[epoch_statistics.size() - 1]);
-
-	// Epidemic peak %
-	int epidemic_peak_size = 0;
-	int epidemic_peak_epoch = 0;
-
-	// Write a line for each epoch
-	for (int epoch_index = 0; epoch_index != epoch_statistics.size(); ++epoch_index) {
-		if (get<1>(epoch_statistics[epoch_index]) > epidemic_peak_size) {
-			epidemic_peak_size = get<1>(epoch_statistics[epoch_index]);
-			epidemic_peak_epoch = epoch_index;
-		}
-	}
+	const EpochMetrics& final_metrics = epoch_metrics.back();
 
 	std::cout << std::endl << "-- Epidemic Results --" << std::endl;
 	std::cout << "Hit: " << static_cast<double>(hit_count) / static_cast<double>(population_count) << " %"<< std::endl;
 	std::cout << "Infected: " << static_cast<double>(infected_count) / static_cast<double>(population_count) << " %" << std::endl;
 	std::cout << "Recovered: " << static_cast<double>(recovered_count) / static_cast<double>(population_count) << " %" << std::endl;
-	std::cout << "Epidemic Peak:" << static_cast<double>(epidemic_peak_size) / static_cast<double>(population_count) << " %" << std::endl;
-	std::cout << "Epidemic Peak Epoch: " << epidemic_peak_epoch << std::endl;
+	std::cout << "Epidemic Peak:" << static_cast<double>(final_metrics.peak_infected_count) / static_cast<double>(population_count) << " %" << std::endl;
+	std::cout << "Epidemic Peak Epoch: " << final_metrics.peak_epoch << std::endl;
+	std::cout << "Growth Rate: " << final_metrics.growth_rate << std::endl;
+	std::cout << "Doubling Time: " << final_metrics.doubling_time << std::endl;
+	std::cout << "R_t: " << final_metrics.reproduction_number << std::endl;
 }
 
 // Asserts the resulting statistics
@@ -1,7 +1,21 @@
 #pragma once
+#include <stdexcept>
 #include <vector>
 #include "Settings.h"
 #include "Individual.h"
+#include "NeighborhoodLookupTable.h"
+#include "EpidemicMetrics.h"
+#include "VenueTable.h"
+#include "ParameterSweep.h"
+#include "Calibration.h"
+
+// Classes of infection prevalence at a location, ordered by severity
+enum PrevalenceClass : std::uint8_t {
+	PrevalenceEmpty, // Nobody is at the location
+	PrevalenceNone, // Nobody at the location is infected
+	PrevalenceMinority, // Less than half of the individuals at the location are infected
+	PrevalenceMajority // At least half of the individuals at the location are infected
+};
 
 // GraphHandler contains only static methods that: Show the epidemic results, save statics to csv, save location graphs to graphviz dot files,
 // generate undirected location graphs, read undirected location graphs from files, allocate random individuals into a graph and
@@ -10,11 +24,48 @@ class GraphHandler {
 public:
 	static boost::unordered_map<int, std::vector<int>> get_node_neighborhood_lookup_map(const LocationUndirectedGraph& location_graph);
 	static std::vector<std::vector<int>> get_node_neighborhood_lookup_vector(const LocationUndirectedGraph& location_graph);
+	static NeighborhoodLookupTable get_node_neighborhood_lookup_table(const LocationUndirectedGraph& location_graph);
 	static std::vector<Individual> get_random_individuals(int individual_count, int location_count);
 	static LocationUndirectedGraph get_location_undirected_graph_from_file(std::string filename);
+	static LocationUndirectedGraph get_location_undirected_graph_from_file(std::string filename, boost::unordered_map<size_t, int>& map_location_to_index);
+	static std::vector<NeighborhoodLookupTable> get_location_layer_tables_from_files(const std::vector<std::string>& filenames,
+		boost::unordered_map<size_t, int>& map_location_to_index);
+	static std::vector<int> get_location_regions_from_file(std::string filename, const boost::unordered_map<size_t, int>& map_location_to_index,
+		int location_count, int& region_count);
+	static VenueTable get_venue_table_from_file(std::string filename, const boost::unordered_map<size_t, int>& map_location_to_index, int location_count);
+	static std::vector<int> get_case_curve_from_file(std::string filename);
+	static std::vector<float> get_proposals_from_file(std::string filename);
 	static LocationUndirectedGraph get_sample_location_undirected_graph();
 	static void save_undirected_graph_to_graphviz_file(std::string filename, const LocationUndirectedGraph& location_graph);
-	static void save_epoch_statistics_to_csv(std::string filename, const std::vector<std::tuple<int, int, int>>& epoch_statistics);
-	static void show_epidemic_results(int population_count, const std::vector<std::tuple<int, int, int>>& epoch_statistics);
+	static void save_prevalence_graph_to_graphviz_file(std::string filename, const NeighborhoodLookupTable& neighborhood_table,
+		const std::vector<Individual>& individuals, int hotspot_count, int hop_count);
+	static std::vector<std::uint8_t> get_location_prevalence_classes(int location_count, const std::vector<Individual>& individuals);
+	static std::vector<int> get_location_infected_counts(int location_count, const std::vector<Individual>& individuals);
+	static void save_epoch_statistics_to_csv(std::string filename, const std::vector<std::tuple<int, int, int>>& epoch_statistics,
+		const std::vector<EpochMetrics>& epoch_metrics, int region_count = 0, const std::vector<int>& region_statistics = std::vector<int>());
+	static void save_cohort_trajectories_to_csv(std::string filename, const std::vector<int>& cohort, const std::vector<int>& locations,
+		const std::vector<std::uint8_t>& states);
+	static void save_sweep_statistics_to_csv(std::string filename, const std::vector<SweepPoint>& sweep_points,
+		const std::vector<std::vector<std::tuple<int, int, int>>>& point_statistics);
+	static void save_calibration_samples_to_csv(std::string filename, const std::vector<CalibrationSample>& samples);
+	static void show_epidemic_results(int population_count, const std::vector<std::tuple<int, int, int>>& epoch_statistics,
+		const std::vector<EpochMetrics>& epoch_metrics);
 	static bool assert_epidemic_results(int population_count, const std::vector<std::tuple<int, int, int>>& epoch_statistics);
-};
\ No newline at end of file
+private:
+	static bool parse_int(const std::string& field, int& value);
+	static bool parse_float(const std::string& field, float& value);
+	static bool parse_node_id(const std::string& field, size_t& value);
+	static std::invalid_argument get_line_error(const std::string& filename, int line_number, const std::string& expected, const std::string& line);
+	static void count_location_occupants(int location_count, const std::vector<Individual>& individuals,
+		std::vector<int>& occupant_counts, std::vector<int>& infected_counts);
+	static std::uint8_t get_prevalence_class(int occupant_count, int infected_count);
+};
+
+// Classify a location by the fraction of its occupants that are infected
+inline std::uint8_t GraphHandler::get_prevalence_class(int occupant_count, int infected_count) {
+	if (occupant_count == 0)
+		return PrevalenceEmpty;
+	if (infected_count == 0)
+		return PrevalenceNone;
+	return (2 * infected_count < occupant_count) ? PrevalenceMinority : PrevalenceMajority;
+}
\ No newline at end of file
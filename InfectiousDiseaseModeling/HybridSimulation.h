@@ -0,0 +1,358 @@
+#pragma once
+#include <omp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <vector>
+#include "CountsSimulation.h"
+
+// Representation of the individuals at a location in the hybrid engine
+enum LocationMode : std::uint8_t {
+	LocationModeAgents, // Every individual is an agent
+	LocationModeCounts // Individuals are counted per class: compartment, epochs in the compartment and, for susceptibles, hit before
+};
+
+// Counts classes of the hybrid engine. Timed compartments have a class for every timer value up to their duration (timers saturate there),
+// untimed ones a single class. Susceptible individuals that were hit before (waning immunity) have classes of their own
+struct CountsClasses {
+	int offsets[COMPARTMENT_COUNT];
+	int bin_counts[COMPARTMENT_COUNT];
+	int hit_susceptible_offset;
+	int class_count;
+	std::vector<std::uint8_t> compartments; // Compartment, timer and hit flag of the agents of every class
+	std::vector<std::uint8_t> timers;
+	std::vector<std::uint8_t> hit;
+
+	int get_class(std::uint8_t compartment, std::uint8_t timer, std::uint8_t hit_before) const;
+};
+
+// Get the class of an individual, all non-susceptible individuals count as hit
+inline int CountsClasses::get_class(std::uint8_t compartment, std::uint8_t timer, std::uint8_t hit_before) const {
+	int offset = (compartment == CompartmentSusceptible && hit_before) ? hit_susceptible_offset : offsets[compartment];
+	return offset + std::min<int>(timer, bin_counts[compartment] - 1);
+}
+
+// Get the counts classes of a model with the given durations
+template <typename Model>
+CountsClasses get_counts_classes(const std::uint8_t* durations) {
+	CountsClasses counts_classes;
+	counts_classes.class_count = 0;
+	for (int compartment = 0; compartment < COMPARTMENT_COUNT; ++compartment) {
+		counts_classes.offsets[compartment] = counts_classes.class_count;
+		counts_classes.bin_counts[compartment] = Model::RULES[compartment].duration == 0 ? 1 : durations[compartment] + 1;
+		counts_classes.class_count += counts_classes.bin_counts[compartment];
+	}
+	counts_classes.hit_susceptible_offset = counts_classes.class_count;
+	counts_classes.class_count += counts_classes.bin_counts[CompartmentSusceptible];
+
+	for (int compartment = 0; compartment < COMPARTMENT_COUNT; ++compartment) {
+		for (int timer = 0; timer < counts_classes.bin_counts[compartment]; ++timer) {
+			counts_classes.compartments.push_back(static_cast<std::uint8_t>(compartment));
+			counts_classes.timers.push_back(static_cast<std::uint8_t>(timer));
+			counts_classes.hit.push_back(compartment == CompartmentSusceptible ? 0 : 1);
+		}
+	}
+	for (int timer = 0; timer < counts_classes.bin_counts[CompartmentSusceptible]; ++timer) {
+		counts_classes.compartments.push_back(CompartmentSusceptible);
+		counts_classes.timers.push_back(static_cast<std::uint8_t>(timer));
+		counts_classes.hit.push_back(1);
+	}
+	return counts_classes;
+}
+
+// Advance the timer classes of one compartment by one epoch, the counterpart of advance_compartment for counts. Every individual
+// whose timer expires leaves with the chance of the rule, the rest waits in the last class. Returns the number leaving
+inline int advance_class_counts(int* class_counts, int bin_count, float probability, std::mt19937& random_engine) {
+	int leaving_count = class_counts[bin_count - 1] + (bin_count > 1 ? class_counts[bin_count - 2] : 0);
+	for (int timer = bin_count - 2; timer > 0; --timer)
+		class_counts[timer] = class_counts[timer - 1];
+	if (bin_count > 1)
+		class_counts[0] = 0;
+
+	int waiting_count = 0;
+	if (probability < 1.0f && leaving_count > 0) {
+		waiting_count = leaving_count - std::binomial_distribution<int>(leaving_count, probability)(random_engine);
+		leaving_count -= waiting_count;
+	}
+	class_counts[bin_count - 1] = waiting_count;
+	return leaving_count;
+}
+
+// Simulate the population with a compartment model, agent based at the locations with few infected individuals and counts based where the
+// infection is widespread. Locations with at least infected_threshold infected (exposed or infectious) individuals at the end of an epoch
+// count their individuals per class in the next epoch, the others keep agents. Individuals are converted when they arrive at a location of
+// the other mode: counts move multinomially and infect binomially, agents as in simulate_compartmental. Individuals of the same class are
+// exchangeable, so the conversions are exact both ways. Honours the same options as simulate_susceptible_counts. Statistics and region
+// statistics are as simulate_compartmental, counts_mode_fractions gets the fraction of the locations in counts mode at the end of every epoch
+template <typename Model>
+void simulate_hybrid(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population,
+	int infected_threshold, std::vector<std::tuple<int, int, int>>& epoch_statistics, std::vector<float>& counts_mode_fractions,
+	const SimulationOptions& options) {
+
+	int location_count = neighborhood_table.node_count();
+
+	// One random engine per thread of the run, seeded from the run seed and the thread number
+	int thread_count = get_run_thread_count();
+	std::vector<std::mt19937> random_engines = get_run_random_engines(options.seed, thread_count);
+
+	std::uint8_t durations[COMPARTMENT_COUNT];
+	get_compartment_durations<Model>(options, durations);
+	CountsClasses counts_classes = get_counts_classes<Model>(durations);
+	int class_count = counts_classes.class_count;
+	int infection_class = counts_classes.get_class(Model::RULES[CompartmentSusceptible].next, 0, 1);
+
+	// Everybody starts as an agent, the modes follow from the initial infections
+	PopulationState agents(initial_population);
+	std::vector<int> class_counts(location_count * class_count, 0);
+	std::vector<int> moved_class_counts(location_count * class_count, 0);
+	std::vector<std::uint8_t> location_modes(location_count);
+	std::vector<int> location_infected_counts(location_count, 0);
+	for (int index = 0; index < agents.size(); ++index)
+		if (agents.compartments[index] == CompartmentExposed || agents.compartments[index] == CompartmentInfectious)
+			++location_infected_counts[agents.locations[index]];
+	std::vector<int> counts_locations; // Locations in counts mode
+	for (int location = 0; location < location_count; ++location) {
+		location_modes[location] = location_infected_counts[location] >= infected_threshold ? LocationModeCounts : LocationModeAgents;
+		if (location_modes[location] == LocationModeCounts)
+			counts_locations.push_back(location);
+	}
+
+	// Turn the counts of a location into agents of their class
+	auto expand_counts = [&](int location) {
+		int* counts = &class_counts[location * class_count];
+		for (int class_index = 0; class_index < class_count; ++class_index) {
+			for (; counts[class_index] > 0; --counts[class_index]) {
+				agents.locations.push_back(location);
+				agents.compartments.push_back(counts_classes.compartments[class_index]);
+				agents.timers.push_back(counts_classes.timers[class_index]);
+				agents.hit.push_back(counts_classes.hit[class_index]);
+			}
+		}
+	};
+
+	float log_escape_chance = std::log(1.0f - options.infectiosity);
+	const float* rate_multipliers = get_rate_multipliers(options, location_count, "simulate_hybrid");
+	std::vector<int> location_infectious_counts(location_count);
+	std::vector<float> location_infection_chances(location_count);
+	std::vector<std::vector<int>> thread_absorbed_indices(thread_count); // Agents that arrived at counts locations, per thread
+	int region_count = get_region_count(options, location_count, "simulate_hybrid");
+	const int* location_regions = region_count > 0 ? options.location_regions->data() : nullptr;
+	epoch_statistics.clear();
+	counts_mode_fractions.clear();
+
+	// Repeat for all the epochs
+	for (int current_epoch = options.first_epoch; current_epoch < (total_epochs + 1); ++current_epoch) {
+
+		int agent_count = agents.size();
+		int hit_count = 0;
+		int infected_count = 0;
+		int recovered_count = 0;
+		int* region_counts = region_count > 0 ? add_region_counts(options) : nullptr;
+
+		#pragma omp parallel num_threads(thread_count)
+		{
+			std::mt19937& random_engine = random_engines[omp_get_thread_num()];
+			std::vector<int> partial_region_counts(region_count * REGION_STATISTIC_COUNT, 0); // Region histogram of this thread
+
+			// Move the counts class by class and the agents one by one. Only the counts locations hold counts, their counts are cleared
+			// as they leave, so the moved counts start from zero in the next epoch
+			#pragma omp for schedule(static) nowait
+			for (int position = 0; position < static_cast<int>(counts_locations.size()); ++position) {
+				int location = counts_locations[position];
+				int* counts = &class_counts[location * class_count];
+				for (int class_index = 0; class_index < class_count; ++class_index) {
+					if (counts[class_index] > 0) {
+						split_location_count(neighborhood_table, location, counts[class_index], &moved_class_counts[class_index], class_count, random_engine);
+						counts[class_index] = 0;
+					}
+				}
+			}
+
+			// Agents arriving at counts locations join the moved counts of their class right away and leave a hole, every thread
+			// collects the holes of its share in increasing order. Without counts locations everybody stays an agent
+			if (counts_locations.empty())
+				move_population(neighborhood_table, nullptr, agents.locations.data(), agent_count, random_engine);
+			else {
+				std::vector<int>& absorbed_indices = thread_absorbed_indices[omp_get_thread_num()];
+				absorbed_indices.clear();
+				#pragma omp for schedule(static)
+				for (int index = 0; index < agent_count; ++index) {
+					int location = agents.locations[index];
+					int degree = neighborhood_table.degree(location);
+					int choice = std::uniform_int_distribution<int>(0, degree)(random_engine);
+					if (choice < degree)
+						location = agents.locations[index] = neighborhood_table.neighbours_begin(location)[choice];
+					if (location_modes[location] == LocationModeCounts) {
+						#pragma omp atomic
+						++moved_class_counts[location * class_count + counts_classes.get_class(agents.compartments[index], agents.timers[index], agents.hit[index])];
+						agents.locations[index] = -1;
+						absorbed_indices.push_back(index);
+					}
+				} // Implicit Barrier
+			}
+
+			// Fill the holes with the last agents, so only the absorbed agents and as many from the end are touched. Counts that reached
+			// agent locations, all neighbours of counts locations, become agents of their class
+			#pragma omp single
+			{
+				class_counts.swap(moved_class_counts);
+				if (!counts_locations.empty()) {
+					int kept_count = agent_count;
+					for (const std::vector<int>& absorbed_indices : thread_absorbed_indices) {
+						for (int hole : absorbed_indices) {
+							while (kept_count > hole && agents.locations[kept_count - 1] == -1)
+								--kept_count;
+							if (hole >= kept_count)
+								continue; // Dropped with the end
+							--kept_count;
+							agents.locations[hole] = agents.locations[kept_count];
+							agents.compartments[hole] = agents.compartments[kept_count];
+							agents.timers[hole] = agents.timers[kept_count];
+							agents.hit[hole] = agents.hit[kept_count];
+						}
+					}
+					agents.locations.resize(kept_count);
+					agents.compartments.resize(kept_count);
+					agents.timers.resize(kept_count);
+					agents.hit.resize(kept_count);
+				}
+
+				for (int counts_location : counts_locations) {
+					for (const int* neighbour = neighborhood_table.neighbours_begin(counts_location); neighbour != neighborhood_table.neighbours_end(counts_location); ++neighbour) {
+						if (location_modes[*neighbour] == LocationModeCounts)
+							continue;
+						expand_counts(*neighbour);
+					}
+				}
+				agent_count = agents.size();
+			} // Implicit Barrier
+
+			// Count the infectious individuals of every location, in its own mode, and reset the infected counts for the advance
+			#pragma omp for schedule(static)
+			for (int location = 0; location < location_count; ++location) {
+				location_infected_counts[location] = 0;
+				int infectious_count = 0;
+				if (location_modes[location] == LocationModeCounts) {
+					const int* counts = &class_counts[location * class_count + counts_classes.offsets[CompartmentInfectious]];
+					for (int timer = 0; timer < counts_classes.bin_counts[CompartmentInfectious]; ++timer)
+						infectious_count += counts[timer];
+				}
+				location_infectious_counts[location] = infectious_count;
+			} // Implicit Barrier
+			#pragma omp for schedule(static)
+			for (int index = 0; index < agent_count; ++index) {
+				if (agents.compartments[index] == CompartmentInfectious) {
+					#pragma omp atomic
+					++location_infectious_counts[agents.locations[index]];
+				}
+			} // Implicit Barrier
+
+			// Infect the susceptible classes of the counts locations binomially
+			#pragma omp for schedule(static)
+			for (int location = 0; location < location_count; ++location) {
+				float infection_chance = 0.0f;
+				if (location_infectious_counts[location] > 0)
+					infection_chance = 1.0f - std::exp(log_escape_chance * (rate_multipliers ? rate_multipliers[location] : 1.0f) * location_infectious_counts[location]);
+				location_infection_chances[location] = infection_chance;
+				if (infection_chance == 0.0f || location_modes[location] == LocationModeAgents)
+					continue;
+
+				int* counts = &class_counts[location * class_count];
+				int infection_count = 0;
+				for (int timer = 0; timer < counts_classes.bin_counts[CompartmentSusceptible]; ++timer) {
+					for (int offset : { counts_classes.offsets[CompartmentSusceptible], counts_classes.hit_susceptible_offset }) {
+						if (counts[offset + timer] > 0) {
+							int class_infection_count = std::binomial_distribution<int>(counts[offset + timer], infection_chance)(random_engine);
+							counts[offset + timer] -= class_infection_count;
+							infection_count += class_infection_count;
+						}
+					}
+				}
+				counts[infection_class] += infection_count;
+				if (location_regions)
+					partial_region_counts[location_regions[location] * REGION_STATISTIC_COUNT + RegionNewInfections] += infection_count;
+			}
+
+			// And the susceptible agents one by one
+			#pragma omp for schedule(static)
+			for (int index = 0; index < agent_count; ++index) {
+				if (agents.compartments[index] == CompartmentSusceptible && location_infection_chances[agents.locations[index]] > 0.0f
+					&& std::uniform_real_distribution<float>(0.0f, 1.0f)(random_engine) < location_infection_chances[agents.locations[index]]) {
+					agents.compartments[index] = Model::RULES[CompartmentSusceptible].next;
+					agents.timers[index] = 0;
+					agents.hit[index] = 1;
+					if (location_regions)
+						++partial_region_counts[location_regions[agents.locations[index]] * REGION_STATISTIC_COUNT + RegionNewInfections];
+				}
+			} // Implicit Barrier
+
+			// Advance the compartments of the counts locations and gather their statistics and infected counts. The individuals leaving
+			// a compartment arrive after all compartments advanced, so nobody advances twice
+			std::vector<int> arriving_counts(class_count);
+			#pragma omp for schedule(static) reduction(+:hit_count, infected_count, recovered_count)
+			for (int position = 0; position < static_cast<int>(counts_locations.size()); ++position) {
+				int location = counts_locations[position];
+				int* counts = &class_counts[location * class_count];
+				std::fill(arriving_counts.begin(), arriving_counts.end(), 0);
+				for (int compartment = 0; compartment < COMPARTMENT_COUNT; ++compartment) {
+					const CompartmentRule& rule = Model::RULES[compartment];
+					if (rule.duration == 0)
+						continue;
+					int bin_count = counts_classes.bin_counts[compartment];
+					int arrival_class = counts_classes.get_class(rule.next, 0, 1);
+					arriving_counts[arrival_class] += advance_class_counts(&counts[counts_classes.offsets[compartment]], bin_count, rule.probability, random_engine);
+					if (compartment == CompartmentSusceptible)
+						arriving_counts[arrival_class] += advance_class_counts(&counts[counts_classes.hit_susceptible_offset], bin_count, rule.probability, random_engine);
+				}
+
+				for (int class_index = 0; class_index < class_count; ++class_index) {
+					counts[class_index] += arriving_counts[class_index];
+					hit_count += counts_classes.hit[class_index] ? counts[class_index] : 0;
+					if (location_regions)
+						count_region_compartment(&partial_region_counts[location_regions[location] * REGION_STATISTIC_COUNT], counts_classes.compartments[class_index], counts[class_index]);
+					if (counts_classes.compartments[class_index] == CompartmentExposed || counts_classes.compartments[class_index] == CompartmentInfectious)
+						location_infected_counts[location] += counts[class_index];
+					else if (counts_classes.compartments[class_index] == CompartmentRecovered)
+						recovered_count += counts[class_index];
+				}
+				infected_count += location_infected_counts[location];
+			} // Implicit Barrier
+
+			// And the agents
+			#pragma omp for schedule(static) reduction(+:hit_count, infected_count, recovered_count)
+			for (int index = 0; index < agent_count; ++index) {
+				advance_individual<Model>(agents.compartments[index], agents.timers[index], durations, random_engine);
+				hit_count += agents.hit[index];
+				if (agents.compartments[index] == CompartmentExposed || agents.compartments[index] == CompartmentInfectious) {
+					++infected_count;
+					#pragma omp atomic
+					++location_infected_counts[agents.locations[index]];
+				}
+				recovered_count += (agents.compartments[index] == CompartmentRecovered) ? 1 : 0;
+				if (location_regions)
+					count_region_compartment(&partial_region_counts[location_regions[agents.locations[index]] * REGION_STATISTIC_COUNT], agents.compartments[index], 1);
+			} // Implicit Barrier
+
+			if (region_counts)
+				merge_region_counts(partial_region_counts, region_counts);
+		}
+
+		// Switch the modes for the next epoch, the locations leaving counts mode turn their counts into agents right away
+		for (int location = 0; location < location_count; ++location)
+			location_modes[location] = location_infected_counts[location] >= infected_threshold ? LocationModeCounts : LocationModeAgents;
+		for (int counts_location : counts_locations)
+			if (location_modes[counts_location] == LocationModeAgents)
+				expand_counts(counts_location);
+		counts_locations.clear();
+		for (int location = 0; location < location_count; ++location)
+			if (location_modes[location] == LocationModeCounts)
+				counts_locations.push_back(location);
+
+		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count));
+		counts_mode_fractions.push_back(location_count > 0 ? static_cast<float>(counts_locations.size()) / location_count : 0.0f);
+		if (options.epoch_observer && !options.epoch_observer(current_epoch, epoch_statistics.back()))
+			break;
+	}
+}
\ No newline at end of file
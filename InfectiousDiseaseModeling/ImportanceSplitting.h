@@ -0,0 +1,83 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+
+// Estimate of a rare outbreak probability by importance splitting
+struct SplittingEstimate {
+	double probability;
+	std::vector<double> level_probabilities; // Fraction of the replicates of every level that reached it
+	long long simulated_epoch_count; // Epochs simulated by all replicates, the cost of the estimate
+};
+
+// Estimate the probability that the hit count reaches the last of the increasing hit_levels by the last epoch, with fixed effort multilevel
+// splitting. Every level runs replicate_count replicates until they reach the level or run out of epochs. The populations that reached it are
+// cloned, in turn, into the replicate_count starting points of the next level, so unlikely paths are followed by many continuations.
+// The probability is the product of the fractions of replicates that reached every level
+template <typename Model>
+SplittingEstimate estimate_outbreak_probability(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population,
+	const std::vector<int>& hit_levels, int replicate_count, const SimulationOptions& base_options) {
+
+	// Starting points of the current level, the population at the end of an epoch and the epoch to continue with
+	struct ReplicateStart {
+		PopulationState population;
+		int first_epoch;
+	};
+
+	SplittingEstimate splitting_estimate = { 1.0, std::vector<double>(), 0 };
+	std::vector<ReplicateStart> starts(1);
+	starts[0].population = initial_population;
+	starts[0].first_epoch = 0;
+	unsigned int run_number = 0; // Every replicate gets its own seed
+
+	for (size_t level = 0; level != hit_levels.size(); ++level) {
+
+		std::vector<ReplicateStart> replicates(replicate_count);
+		std::vector<char> reached(replicate_count, 0);
+		long long level_epoch_count = 0;
+
+		#pragma omp parallel for schedule(dynamic, 1) reduction(+:level_epoch_count)
+		for (int replicate_index = 0; replicate_index < replicate_count; ++replicate_index) {
+			ReplicateStart& replicate = replicates[replicate_index];
+			replicate = starts[replicate_index % starts.size()]; // Clone the starting population
+			if (std::count(replicate.population.hit.begin(), replicate.population.hit.end(), 1) >= hit_levels[level]) {
+				reached[replicate_index] = 1; // Reached this level together with the previous one
+				continue;
+			}
+
+			SimulationOptions options(base_options);
+			options.seed = base_options.seed + run_number + replicate_index;
+			options.region_statistics = nullptr; // Replicates run concurrently, region counts belong to single runs
+			options.first_epoch = replicate.first_epoch;
+			options.epoch_observer = [&](int epoch, const std::tuple<int, int, int>& statistics) {
+				if (std::get<0>(statistics) < hit_levels[level])
+					return true;
+				reached[replicate_index] = 1;
+				replicate.first_epoch = epoch + 1;
+				return false;
+			};
+
+			std::vector<std::tuple<int, int, int>> epoch_statistics;
+			simulate_compartmental<Model>(total_epochs, neighborhood_table, replicate.population, epoch_statistics, options);
+			level_epoch_count += static_cast<long long>(epoch_statistics.size());
+		}
+		run_number += replicate_count;
+		splitting_estimate.simulated_epoch_count += level_epoch_count;
+
+		// The replicates that reached the level start the next one
+		starts.clear();
+		for (int replicate_index = 0; replicate_index < replicate_count; ++replicate_index)
+			if (reached[replicate_index])
+				starts.push_back(replicates[replicate_index]);
+
+		double level_probability = static_cast<double>(starts.size()) / replicate_count;
+		splitting_estimate.level_probabilities.push_back(level_probability);
+		splitting_estimate.probability *= level_probability;
+		if (starts.empty())
+			break;
+	}
+
+	return splitting_estimate;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 #include "IndividualParameters.h"
 
@@ -15,6 +16,7 @@ public:
 	void move(std::vector<int>& new_locations);
 	void set_location(int location);
 	int get_location() const;
+	std::uint8_t get_epochs_infected() const;
 	bool is_infected() const;
 	bool is_hit() const;
 	bool is_recovered() const;
@@ -63,6 +65,11 @@ inline int Individual::get_location() const {
 	return location_;
 }
 
+// Get the number of epochs the individual has been infected
+inline std::uint8_t Individual::get_epochs_infected() const {
+	return epochs_infected_;
+}
+
 // Check if individual is currently infected
 inline bool Individual::is_infected() const {
 	return infected_;
@@ -1,8 +1,11 @@
 #pragma once
+#include <cstdint>
+
+static const std::uint8_t DEFAULT_DISEASE_DURATION = 7; // Shared with the infectious duration of SirModel
 
 // This struct defines the chance for an individual to get infected as well as,
 // the infection period in epochs
 struct IndividualParameters {
 	float Infectiosity = 0.13;
-	std::uint8_t DiseaseDuration = 7;
+	std::uint8_t DiseaseDuration = DEFAULT_DISEASE_DURATION;
 };
\ No newline at end of file
@@ -2,9 +2,26 @@
 #include <ctime>
 #include <iostream>
 #include <sstream>
+#include <random>
+#include <stdexcept>
 #include "Individual.h"
 #include "GraphHandler.h"
 #include "Settings.h"
+#include "TelemetryPage.h"
+#include "ResultsStream.h"
+#include "FrameWriter.h"
+#include "ColocationIndex.h"
+#include "AnalyserHost.h"
+#include "CohortSampler.h"
+#include "CompartmentalSimulation.h"
+#include "ParameterSweep.h"
+#include "Calibration.h"
+#include "ImportanceSplitting.h"
+#include "MeanFieldSimulation.h"
+#include "CountsSimulation.h"
+#include "HybridSimulation.h"
+#include "EventDrivenSimulation.h"
+#include "MultistrainSimulation.h"
 #include <fstream>
 
 using namespace std;
@@ -21,6 +38,11 @@ void simulate_serial(int individual_count, std::uint8_t total_epochs, const Loca
 	//boost::unordered_map<int, vector<int>> neighborhood_lookup_map = GraphHandler::get_node_neighborhood_lookup_map(individual_graph);
 	vector<vector<int>> neighborhood_lookup_vector = GraphHandler::get_node_neighborhood_lookup_vector(individual_graph);
 
+	// Online epidemic metrics, updated once per epoch
+	EpidemicMetrics epidemic_metrics(IndividualParameters().DiseaseDuration + 1, INITIAL_INFECTED_COUNT);
+	vector<EpochMetrics> epoch_metrics;
+	epoch_statistics.clear(); // Statistics and metrics are kept per simulation run
+
 	// Repeat for all the epochs
 	for (std::uint8_t current_epoch = 0; current_epoch < (total_epochs + 1); ++current_epoch) {
 
@@ -71,30 +93,89 @@ void simulate_serial(int individual_count, std::uint8_t total_epochs, const Loca
 		}
 
 		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count)); // Store tuple of statistics for the current epoch
+		epoch_metrics.push_back(epidemic_metrics.advance_epoch(hit_count, infected_count));
 	}
 
 	if (SAVE_CSV)
-		GraphHandler::save_epoch_statistics_to_csv("output.csv", epoch_statistics);
+		GraphHandler::save_epoch_statistics_to_csv("output.csv", epoch_statistics, epoch_metrics);
 	if (SAVE_GRAPHVIZ)
 		GraphHandler::save_undirected_graph_to_graphviz_file("individualGraph.dot", individual_graph);
 	if (SHOW_EPIDEMIC_RESULTS)
-		GraphHandler::show_epidemic_results(individual_count, epoch_statistics);
+		GraphHandler::show_epidemic_results(individual_count, epoch_statistics, epoch_metrics);
 }
 
 void simulate_parallel(int individual_count, std::uint8_t total_epochs, const LocationUndirectedGraph& individual_graph,
-	vector<Individual>& individuals, vector<std::tuple<int, int, int>>& epoch_statistics) {
+	vector<Individual>& individuals, vector<std::tuple<int, int, int>>& epoch_statistics, const vector<int>& location_regions, int region_count) {
 
 	int index = 0;
 	int max_index = static_cast<int>(individuals.size());
 	int chunk = static_cast<int>(max_index / DEFAULT_NUMBER_OF_THREADS);
+	int location_count = static_cast<int>(num_vertices(individual_graph));
 
 	// Generate a look up map with the neighbouring nodes for each graph node
 	boost::unordered_map<int, vector<int>> neighborhood_lookup_map = GraphHandler::get_node_neighborhood_lookup_map(individual_graph);
 
+	// In-situ analysers, run on worker threads while the next epoch is simulated
+	AnalyserHost analyser_host;
+	analyser_host.load_plugins(ANALYSER_PLUGIN_PATHS);
+
+	// The graphviz and binary frames and the analysers read the compressed neighbourhood table
+	NeighborhoodLookupTable neighborhood_table;
+	if (SAVE_GRAPHVIZ_FRAMES || SAVE_FRAMES || !analyser_host.empty())
+		neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+	analyser_host.set_location_graph(neighborhood_table);
+
+	// Binary prevalence frames, written by a background thread
+	FrameWriter frame_writer;
+	if (SAVE_FRAMES && !frame_writer.open(FRAMES_FILENAME, neighborhood_table, FRAME_BYTES_PER_EPOCH))
+		cout << "Frames disabled: cannot write " << FRAMES_FILENAME << " or a frame of " << FrameWriter::get_max_frame_size(neighborhood_table.node_count())
+			<< " bytes exceeds the burst of FRAME_BYTES_PER_EPOCH" << endl;
+
+	// Online epidemic metrics, updated once per epoch
+	EpidemicMetrics epidemic_metrics(IndividualParameters().DiseaseDuration + 1, INITIAL_INFECTED_COUNT);
+	vector<EpochMetrics> epoch_metrics;
+	epoch_statistics.clear(); // Statistics and metrics are kept per simulation run
+
+	// Susceptible, infected, recovered and new infection counts per region, accumulated by the statistics pass (empty regions disable them)
+	bool count_regions = !location_regions.empty();
+	vector<int> epoch_region_counts;
+	vector<int> region_statistics;
+
+	// Random cohort whose locations and states are logged every epoch
+	CohortSampler cohort_sampler;
+	if (TRACK_COHORT)
+		cohort_sampler.select(individuals, COHORT_SIZE, COHORT_STRATIFIED, std::random_device()());
+
+	// Rolling co-location index for contact tracing, the newly infected individuals of every epoch are traced in one batch
+	ColocationIndex colocation_index;
+	vector<int> traced_individuals;
+	vector<vector<int>> traced_contacts;
+	int traced_contact_count = 0;
+	if (TRACE_CONTACTS)
+		colocation_index.open(CONTACT_TRACING_WINDOW);
+
+	// Live telemetry page in shared memory, updated at the end of every epoch
+	TelemetryPage telemetry_page;
+	if (PUBLISH_TELEMETRY)
+		telemetry_page.open_writer(TELEMETRY_SEGMENT_NAME);
+	double simulation_start_time = omp_get_wtime();
+	double phase_start_time, move_time, infect_time, advance_time;
+
+	// Per-epoch results in a shared memory ring buffer, optionally with the locations whose infected count changed
+	ResultsStream results_stream;
+	vector<int> previous_location_infected_counts;
+	vector<LocationDelta> location_deltas;
+	if (PUBLISH_RESULTS_STREAM) {
+		results_stream.open_producer(RESULTS_STREAM_SEGMENT_NAME, RESULTS_STREAM_SLOT_COUNT, RESULTS_STREAM_MAX_LOCATION_DELTAS, location_count,
+			RESULTS_STREAM_DROP_WHEN_FULL ? ResultsStreamDrop : ResultsStreamWait, RESULTS_STREAM_MAX_WAIT_MICROSECONDS);
+		previous_location_infected_counts.assign(location_count, 0);
+	}
+
 	// Repeat for all the epochs
 	for (std::uint8_t current_epoch = 0; current_epoch < (total_epochs + 1); ++current_epoch) {
 
 		//	Randomly move all individuals
+		phase_start_time = omp_get_wtime();
 		#pragma omp parallel private(index) shared(individuals, neighborhood_lookup_map) firstprivate(chunk, max_index)
 		{
 			#pragma omp for schedule(static, chunk) nowait
@@ -108,8 +189,10 @@ void simulate_parallel(int individual_count, std::uint8_t total_epochs, const Lo
 				individuals[index] = current_individual; // Save individual back to the shared memory space
 			}
 		} // Implicit Barrier
+		move_time = omp_get_wtime() - phase_start_time;
 			
 		// Try to infect individuals that are close to infected ones
+		phase_start_time = omp_get_wtime();
 		#pragma omp parallel private(index) shared(individuals) firstprivate(chunk, max_index)
 		{
 			// Since we only change individuals that are "chunked" by index for each thread, there is no need for critical/atomic region
@@ -135,13 +218,24 @@ void simulate_parallel(int individual_count, std::uint8_t total_epochs, const Lo
 			}
 
 		} // Implicit Barrier
+		infect_time = omp_get_wtime() - phase_start_time;
+
+		// Locations don't change until the next epoch, so the buckets of this epoch are final
+		if (colocation_index.is_open())
+			colocation_index.record_epoch(individuals, location_count);
 
 		// Advance the epoch for every individual and gather infected & hit statistics
+		phase_start_time = omp_get_wtime();
 		int hit_count = 0;
 		int infected_count = 0;
 		int recovered_count = 0;
-		#pragma omp parallel private(index) shared(individuals) firstprivate(chunk, max_index) reduction(+:infected_count, hit_count, recovered_count)
+		if (count_regions)
+			epoch_region_counts.assign(region_count * REGION_STATISTIC_COUNT, 0);
+		#pragma omp parallel private(index) shared(individuals, epoch_region_counts) firstprivate(chunk, max_index) reduction(+:infected_count, hit_count, recovered_count)
 		{
+			// Partial region histogram of this thread, merged into the epoch histogram at the end of the region
+			vector<int> partial_region_counts(count_regions ? region_count * REGION_STATISTIC_COUNT : 0, 0);
+
 			// Since we only change individuals that are "chunked" by index for each thread, there is no need for critical/atomic region
 			#pragma omp for schedule(static, chunk) nowait
 			for (index = 0; index < max_index; ++index) {		
@@ -155,18 +249,97 @@ void simulate_parallel(int individual_count, std::uint8_t total_epochs, const Lo
 					++hit_count;
 				if (current_individual.is_recovered())
 					++recovered_count;
+				if (count_regions) {
+					int* region_counts = &partial_region_counts[location_regions[current_individual.get_location()] * REGION_STATISTIC_COUNT];
+					++region_counts[current_individual.is_infected() ? RegionInfected : (current_individual.is_recovered() ? RegionRecovered : RegionSusceptible)];
+					if (current_individual.is_infected() && current_individual.get_epochs_infected() == 1) // Infected during this epoch
+						++region_counts[RegionNewInfections];
+				}
 			}
+
+			if (count_regions)
+				merge_region_counts(partial_region_counts, epoch_region_counts.data());
 		} // Implicit Barrier
+		advance_time = omp_get_wtime() - phase_start_time;
+
+		if (colocation_index.is_open()) {
+			traced_individuals.clear();
+			for (index = 0; index < max_index; ++index)
+				if (individuals[index].is_infected() && individuals[index].get_epochs_infected() == 1) // Infected during this epoch
+					traced_individuals.push_back(index);
+
+			colocation_index.get_contacts(traced_individuals, CONTACT_TRACING_WINDOW, traced_contacts);
+			for (const vector<int>& contacts : traced_contacts)
+				traced_contact_count += static_cast<int>(contacts.size());
+		}
 
 		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count)); // Store tuple of statistics for the current epoch
+		epoch_metrics.push_back(epidemic_metrics.advance_epoch(hit_count, infected_count));
+		if (count_regions)
+			region_statistics.insert(region_statistics.end(), epoch_region_counts.begin(), epoch_region_counts.end());
+		if (!cohort_sampler.empty())
+			cohort_sampler.record_epoch(individuals);
+
+		if (telemetry_page.is_open()) {
+			TelemetryRecord telemetry_record;
+			telemetry_record.epoch = current_epoch;
+			telemetry_record.total_epochs = total_epochs;
+			telemetry_record.population_count = individual_count;
+			telemetry_record.susceptible_count = individual_count - hit_count; // Recovered individuals are immune
+			telemetry_record.infected_count = infected_count;
+			telemetry_record.recovered_count = recovered_count;
+			telemetry_record.move_time_ms = move_time * 1000.0;
+			telemetry_record.infect_time_ms = infect_time * 1000.0;
+			telemetry_record.advance_time_ms = advance_time * 1000.0;
+			telemetry_record.agent_epochs_per_second = static_cast<double>(individual_count) * (current_epoch + 1) / (omp_get_wtime() - simulation_start_time);
+			telemetry_page.publish(telemetry_record);
+		}
+
+		if (results_stream.is_open()) {
+			location_deltas.clear();
+			if (RESULTS_STREAM_MAX_LOCATION_DELTAS > 0) {
+				vector<int> location_infected_counts = GraphHandler::get_location_infected_counts(location_count, individuals);
+				for (int location = 0; location < location_count; ++location) {
+					if (location_infected_counts[location] != previous_location_infected_counts[location]) {
+						LocationDelta location_delta = { location, location_infected_counts[location] - previous_location_infected_counts[location] };
+						location_deltas.push_back(location_delta);
+					}
+				}
+				previous_location_infected_counts.swap(location_infected_counts);
+			}
+
+			const EpochMetrics& metrics = epoch_metrics.back();
+			ResultsRecord results_record = { current_epoch, hit_count, infected_count, recovered_count, metrics.new_infections, 0, 0, 0,
+				metrics.growth_rate, metrics.reproduction_number };
+			results_stream.publish(results_record, location_deltas); // Dropped when the consumer lags behind longer than the settings allow
+		}
+
+		if (SAVE_GRAPHVIZ_FRAMES)
+			GraphHandler::save_prevalence_graph_to_graphviz_file("frame_" + std::to_string(current_epoch) + ".dot", neighborhood_table,
+				individuals, GRAPHVIZ_HOTSPOT_COUNT, GRAPHVIZ_HOP_COUNT);
+		if (frame_writer.is_open())
+			frame_writer.write_frame(current_epoch, GraphHandler::get_location_prevalence_classes(neighborhood_table.node_count(), individuals));
+		if (!analyser_host.empty() && (current_epoch % ANALYSER_EPOCH_INTERVAL == 0 || current_epoch == total_epochs))
+			analyser_host.submit_epoch(current_epoch, individuals);
 	}
 
+	if (results_stream.is_open())
+		results_stream.finish();
+	if (frame_writer.is_open())
+		frame_writer.close();
+	if (!analyser_host.empty())
+		analyser_host.finish();
+
 	if (SAVE_CSV)
-		GraphHandler::save_epoch_statistics_to_csv("output.csv", epoch_statistics);
+		GraphHandler::save_epoch_statistics_to_csv("output.csv", epoch_statistics, epoch_metrics, count_regions ? region_count : 0, region_statistics);
+	if (SAVE_CSV && !cohort_sampler.empty())
+		GraphHandler::save_cohort_trajectories_to_csv("cohort.csv", cohort_sampler.get_cohort(), cohort_sampler.get_locations(), cohort_sampler.get_states());
 	if (SAVE_GRAPHVIZ)
 		GraphHandler::save_undirected_graph_to_graphviz_file("individualGraph.dot", individual_graph);
 	if (SHOW_EPIDEMIC_RESULTS)
-		GraphHandler::show_epidemic_results(individual_count, epoch_statistics);
+		GraphHandler::show_epidemic_results(individual_count, epoch_statistics, epoch_metrics);
+	if (SHOW_EPIDEMIC_RESULTS && colocation_index.is_open())
+		std::cout << "Traced Contacts: " << traced_contact_count << std::endl;
 }
 
 void simulate_serial_naive(int individual_count, int total_epochs, const LocationUndirectedGraph& individual_graph, vector<Individual>& individuals) {
@@ -177,6 +350,10 @@ void simulate_serial_naive(int individual_count, int total_epochs, const Locatio
 	// Generate a look up map with the neighbouring nodes for each graph node
 	boost::unordered_map<int, vector<int>> neighborhood_lookup_map = GraphHandler::get_node_neighborhood_lookup_map(individual_graph);
 
+	// Online epidemic metrics, updated once per epoch
+	EpidemicMetrics epidemic_metrics(IndividualParameters().DiseaseDuration + 1, INITIAL_INFECTED_COUNT);
+	vector<EpochMetrics> epoch_metrics;
+
 	// Repeat for all the epochs
 	for (int current_epoch = 0; current_epoch < (total_epochs + 1); ++current_epoch) {
 		
@@ -217,23 +394,37 @@ void simulate_serial_naive(int individual_count, int total_epochs, const Locatio
 				++recovered_count;
 		}
 		epoch_statistics.push_back(std::make_tuple(hit_count, infected_count, recovered_count));
+		epoch_metrics.push_back(epidemic_metrics.advance_epoch(hit_count, infected_count));
 	}
 	
 	if (SAVE_CSV)
-		GraphHandler::save_epoch_statistics_to_csv("output.csv", epoch_statistics);
+		GraphHandler::save_epoch_statistics_to_csv("output.csv", epoch_statistics, epoch_metrics);
 	if (SAVE_GRAPHVIZ)
 		GraphHandler::save_undirected_graph_to_graphviz_file("individualGraph.dot", individual_graph);
 	if (SHOW_EPIDEMIC_RESULTS)
-		GraphHandler::show_epidemic_results(individual_count, epoch_statistics);
+		GraphHandler::show_epidemic_results(individual_count, epoch_statistics, epoch_metrics);
 }
 
-void reset_input(string filename, int individual_count, int& location_count, int& edge_count, LocationUndirectedGraph& individual_graph, vector<Individual>& individuals) {
-	individual_graph = GraphHandler::get_location_undirected_graph_from_file(filename); // Read graph from File OR
+void reset_input(string filename, int individual_count, int& location_count, int& edge_count, LocationUndirectedGraph& individual_graph, vector<Individual>& individuals,
+	vector<int>& location_regions, int& region_count, VenueTable& venue_table) {
+	boost::unordered_map<size_t, int> map_location_to_index; // Openstreet map node ids of the graph nodes
+	individual_graph = GraphHandler::get_location_undirected_graph_from_file(filename, map_location_to_index); // Read graph from File OR
 	//individual_graph = GraphHandler::get_sample_location_undirected_graph(); // Generate sample graph
 
 	location_count = individual_graph.m_vertices.size();
 	edge_count = individual_graph.m_edges.size();
 
+	// Regions of the locations, read alongside the edges
+	location_regions.clear();
+	region_count = 0;
+	if (std::string(REGION_MAPPING_FILENAME) != "")
+		location_regions = GraphHandler::get_location_regions_from_file(REGION_MAPPING_FILENAME, map_location_to_index, location_count, region_count);
+
+	// Venue attributes of the locations, read alongside the edges
+	venue_table = VenueTable();
+	if (std::string(VENUE_ATTRIBUTES_FILENAME) != "")
+		venue_table = GraphHandler::get_venue_table_from_file(VENUE_ATTRIBUTES_FILENAME, map_location_to_index, location_count);
+
 	individuals = GraphHandler::get_random_individuals(individual_count, location_count); // Randomize positions of individuals
 
 	// Infect initial individuals
@@ -276,10 +467,13 @@ void benchmark() {
 	LocationUndirectedGraph individual_graph; //Graph of location nodes & connections
 	int location_count, edge_count;
 	vector<Individual> individuals; // Population of healthy individuals
+	vector<int> location_regions; // Region of every location, empty without a region mapping file
+	int region_count;
+	VenueTable venue_table; // Venue attributes of every location, empty without a venue attributes file
 	vector<std::tuple<int, int, int>> epoch_statistics;
 
 	// Reset individuals
-	reset_input(input_graph_filename, benchmark_init_individual_count, location_count, edge_count, individual_graph, individuals);
+	reset_input(input_graph_filename, benchmark_init_individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table);
 	std::cout << "Location Count: " << location_count << std::endl; // print info once
 	std::cout << "Edge Count: " << edge_count << std::endl; // print info once
 
@@ -293,7 +487,7 @@ void benchmark() {
 		total_time = 0.0;
 		average_execution_time = 0.0;
 		for (std::uint8_t current_repeat = 0; current_repeat != benchmark_repeat_count; ++current_repeat) {
-			reset_input(input_graph_filename, benchmark_individual_count, location_count, edge_count, individual_graph, individuals); // Reset individuals
+			reset_input(input_graph_filename, benchmark_individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
 			time_start = omp_get_wtime();
 			simulate_serial(benchmark_individual_count, total_epochs, individual_graph, individuals, epoch_statistics);
 			time_end = omp_get_wtime() - time_start;
@@ -322,9 +516,9 @@ void benchmark() {
 			total_time = 0.0;
 			average_execution_time = 0.0;
 			for (std::uint8_t current_repeat = 0; current_repeat != benchmark_repeat_count; ++current_repeat) {
-				reset_input(input_graph_filename, benchmark_individual_count, location_count, edge_count, individual_graph, individuals); // Reset individuals
+				reset_input(input_graph_filename, benchmark_individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
 				time_start = omp_get_wtime();
-				simulate_parallel(benchmark_individual_count, total_epochs, individual_graph, individuals, epoch_statistics);
+				simulate_parallel(benchmark_individual_count, total_epochs, individual_graph, individuals, epoch_statistics, location_regions, region_count);
 				time_end = omp_get_wtime() - time_start;
 				total_time += time_end;
 				if (!GraphHandler::assert_epidemic_results(benchmark_individual_count, epoch_statistics))
@@ -354,13 +548,391 @@ void benchmark() {
 	system("pause");
 }
 
-int main() {
+// Compare the move kernel throughput without a mask, with a mask that has nothing closed and with a mask that closed a share of the nodes
+void benchmark_interventions() {
+
+	string input_graph_filename = "antwerp.edges";
+	int individual_count = 503138; // population of Antwerp is 503138
+	int total_epochs = 30;
+	int thread_count = DEFAULT_NUMBER_OF_THREADS;
+	double closed_node_fraction = 0.1;
+
+	omp_set_num_threads(thread_count);
+	std::cout << "----- Benchmark Intervention Masks -----" << std::endl;
+
+	LocationUndirectedGraph individual_graph = GraphHandler::get_location_undirected_graph_from_file(input_graph_filename);
+	NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+	int location_count = neighborhood_table.node_count();
+	vector<Individual> individuals = GraphHandler::get_random_individuals(individual_count, location_count);
+
+	InterventionMask open_mask;
+	open_mask.open(neighborhood_table);
+	InterventionMask closed_mask;
+	closed_mask.open(neighborhood_table);
+	std::mt19937 random_engine(1);
+	for (int closed_node_count = 0; closed_node_count < location_count * closed_node_fraction; ++closed_node_count)
+		closed_mask.close_node(std::uniform_int_distribution<int>(0, location_count - 1)(random_engine));
+
+	std::string benchmark_file_name = "benchmark_interventions.csv";
+	std::stringstream benchmark_string_stream;
+	benchmark_string_stream << "execution_time,mask_type,thread_count,individual_count,node_count,total_epochs,moves_per_second" << std::endl;
+
+	const char* mask_types[] = { "none", "open", "closed" };
+	const InterventionMask* masks[] = { nullptr, &open_mask, &closed_mask };
+	for (int mask_index = 0; mask_index != 3; ++mask_index) {
+
+		PopulationState population;
+		population.assign(individuals);
+		vector<std::mt19937> random_engines;
+		for (int thread_number = 0; thread_number < omp_get_max_threads(); ++thread_number)
+			random_engines.push_back(std::mt19937(thread_number));
+
+		double time_start = omp_get_wtime();
+		for (int current_epoch = 0; current_epoch < total_epochs; ++current_epoch) {
+			#pragma omp parallel
+			move_population(neighborhood_table, masks[mask_index], population.locations.data(), individual_count, random_engines[omp_get_thread_num()]);
+		}
+		double execution_time = (omp_get_wtime() - time_start) * 1000.0;
+		double moves_per_second = static_cast<double>(individual_count) * total_epochs / (execution_time / 1000.0);
+
+		std::cout << "Mask " << mask_types[mask_index] << ": " << execution_time << " ms, " << moves_per_second << " moves/s" << std::endl;
+		benchmark_string_stream << execution_time << "," << mask_types[mask_index] << "," << thread_count << "," << individual_count << ","
+			<< location_count << "," << total_epochs << "," << moves_per_second << std::endl;
+	}
+
+	std::cout << std::endl << "Writing results to csv: " << benchmark_file_name << endl;
+
+	std::ofstream output_benchmark_csv;
+	output_benchmark_csv.open(std::string(benchmark_file_name));
+	output_benchmark_csv << benchmark_string_stream.str();
+	output_benchmark_csv.close();
+}
+
+// Sweep the infectiosity, the disease duration and the initial infected count of the SIR model, with replicates, over one graph and one initial population
+void parameter_sweep() {
+
+	string input_graph_filename = "antwerp.edges";
+	int individual_count = 100000;
+	std::uint8_t total_epochs = 30;
+	int thread_count = DEFAULT_NUMBER_OF_THREADS;
+	vector<float> infectiosities = { 0.05f, 0.1f, 0.15f, 0.2f };
+	vector<std::uint8_t> disease_durations = { 5, 7, 10 };
+	vector<int> initial_infected_counts = { 5, 15, 50 };
+	unsigned int replicate_count = 4;
+
+	omp_set_num_threads(thread_count);
+	std::cout << "----- Parameter Sweep -----" << std::endl;
+
+	// The graph and the initial population are shared by all the points
+	LocationUndirectedGraph individual_graph;
+	int location_count, edge_count;
+	vector<Individual> individuals;
+	vector<int> location_regions;
+	int region_count;
+	VenueTable venue_table;
+	reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table);
+	NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+	PopulationState initial_population;
+	initial_population.assign(individuals);
+	std::fill(initial_population.compartments.begin(), initial_population.compartments.end(), CompartmentSusceptible); // Every point infects its own
+	std::fill(initial_population.timers.begin(), initial_population.timers.end(), 0);
+	std::fill(initial_population.hit.begin(), initial_population.hit.end(), 0);
+
+	SimulationOptions simulation_options;
+	simulation_options.seed = 1; // Replicates run with seeds 1, 2, ...
+	if (venue_table.node_count() > 0)
+		simulation_options.venue_table = &venue_table;
+
+	vector<SweepPoint> sweep_points = get_sweep_points(infectiosities, disease_durations, initial_infected_counts, replicate_count);
+	vector<vector<std::tuple<int, int, int>>> point_statistics;
+	double time_start = omp_get_wtime();
+	run_parameter_sweep<SirModel>(total_epochs, neighborhood_table, initial_population, sweep_points, simulation_options, point_statistics);
+	double execution_time = omp_get_wtime() - time_start;
+
+	std::cout << sweep_points.size() << " points in " << execution_time * 1000.0 << " ms" << std::endl;
+	GraphHandler::save_sweep_statistics_to_csv("sweep.csv", sweep_points, point_statistics);
+}
+
+// Calibrate the infectiosity of the SIR model to a cumulative case curve by approximate Bayesian computation and report the throughput
+void calibration() {
+
+	string input_graph_filename = "minimumantwerp.edges";
+	string observed_cases_filename = ""; // Synthetic observations of a reference run when empty
+	string proposals_filename = ""; // Uniform prior samples when empty
+	int individual_count = 4000;
+	std::uint8_t total_epochs = 30;
+	int thread_count = DEFAULT_NUMBER_OF_THREADS;
+	float reference_infectiosity = 0.13f;
+	int proposal_count = 10000;
+	double tolerance = 500.0;
+
+	omp_set_num_threads(thread_count);
+	std::cout << "----- ABC Calibration -----" << std::endl;
+
+	LocationUndirectedGraph individual_graph;
+	int location_count, edge_count;
+	vector<Individual> individuals;
+	vector<int> location_regions;
+	int region_count;
+	VenueTable venue_table;
+	reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table);
+	NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+	PopulationState initial_population;
+	initial_population.assign(individuals);
+
+	SimulationOptions simulation_options;
+	if (venue_table.node_count() > 0)
+		simulation_options.venue_table = &venue_table;
+
+	vector<int> observed_cases;
+	if (observed_cases_filename != "") {
+		try {
+			observed_cases = GraphHandler::get_case_curve_from_file(observed_cases_filename);
+		}
+		catch (const std::invalid_argument& error) {
+			std::cout << "Invalid case curve: " << error.what() << std::endl;
+			return;
+		}
+		if (observed_cases.empty() || observed_cases.size() > 256) {
+			std::cout << "Invalid case curve: between 1 and 256 epochs are supported, got " << observed_cases.size() << std::endl;
+			return;
+		}
+	}
+	else {
+		PopulationState reference_population(initial_population);
+		SimulationOptions reference_options(simulation_options);
+		reference_options.infectiosity = reference_infectiosity;
+		vector<std::tuple<int, int, int>> reference_statistics;
+		simulate_compartmental<SirModel>(total_epochs, neighborhood_table, reference_population, reference_statistics, reference_options);
+		for (const std::tuple<int, int, int>& statistics : reference_statistics)
+			observed_cases.push_back(get<0>(statistics));
+	}
+
+	vector<float> proposals;
+	try {
+		proposals = proposals_filename != "" ? GraphHandler::get_proposals_from_file(proposals_filename) : get_uniform_proposals(proposal_count, 0.0f, 0.4f, 1);
+	}
+	catch (const std::invalid_argument& error) {
+		std::cout << "Invalid proposals: " << error.what() << std::endl;
+		return;
+	}
+
+	vector<CalibrationSample> samples;
+	double time_start = omp_get_wtime();
+	run_abc_calibration<SirModel>(neighborhood_table, initial_population, observed_cases, proposals, tolerance, simulation_options, samples);
+	double execution_time = omp_get_wtime() - time_start;
+
+	int accepted_count = 0;
+	long long simulated_epoch_count = 0;
+	double accepted_infectiosity_sum = 0.0;
+	for (const CalibrationSample& sample : samples) {
+		simulated_epoch_count += sample.epoch_count;
+		if (sample.accepted) {
+			++accepted_count;
+			accepted_infectiosity_sum += sample.infectiosity;
+		}
+	}
+
+	std::cout << "Simulations: " << samples.size() << " in " << execution_time * 1000.0 << " ms, " << samples.size() / execution_time << " simulations/s" << std::endl;
+	std::cout << "Simulated epochs: " << simulated_epoch_count << " of " << samples.size() * observed_cases.size() << std::endl;
+	std::cout << "Accepted: " << accepted_count << ", mean infectiosity " << (accepted_count > 0 ? accepted_infectiosity_sum / accepted_count : 0.0) << std::endl;
+	GraphHandler::save_calibration_samples_to_csv("calibration.csv", samples);
+}
+
+// Estimate the probability of a large outbreak under weak transmission by importance splitting, and naively with the same number of epochs
+void importance_splitting() {
+
+	string input_graph_filename = "minimumantwerp.edges";
+	int individual_count = 4000;
+	std::uint8_t total_epochs = 30;
+	int thread_count = DEFAULT_NUMBER_OF_THREADS;
+	float infectiosity = 0.01f;
+	vector<int> hit_levels = { 25, 30, 35, 40, 45, 50, 55, 60 };
+	int replicate_count = 1000;
+
+	omp_set_num_threads(thread_count);
+	std::cout << "----- Importance Splitting -----" << std::endl;
+
+	LocationUndirectedGraph individual_graph;
+	int location_count, edge_count;
+	vector<Individual> individuals;
+	vector<int> location_regions;
+	int region_count;
+	VenueTable venue_table;
+	reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table);
+	NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+	PopulationState initial_population;
+	initial_population.assign(individuals);
+
+	SimulationOptions simulation_options;
+	simulation_options.infectiosity = infectiosity;
+	if (venue_table.node_count() > 0)
+		simulation_options.venue_table = &venue_table;
+
+	double time_start = omp_get_wtime();
+	SplittingEstimate splitting_estimate = estimate_outbreak_probability<SirModel>(total_epochs, neighborhood_table, initial_population, hit_levels,
+		replicate_count, simulation_options);
+	double execution_time = omp_get_wtime() - time_start;
+
+	std::cout << "Splitting estimate: " << splitting_estimate.probability << " (levels";
+	for (double level_probability : splitting_estimate.level_probabilities)
+		std::cout << " " << level_probability;
+	std::cout << "), " << splitting_estimate.simulated_epoch_count << " epochs in " << execution_time * 1000.0 << " ms" << std::endl;
+
+	// Naive replicates of the full run, until they simulated as many epochs as the splitting estimate
+	long long naive_epoch_count = 0;
+	int naive_replicate_count = 0;
+	int naive_outbreak_count = 0;
+	time_start = omp_get_wtime();
+	while (naive_epoch_count < splitting_estimate.simulated_epoch_count) {
+		PopulationState population(initial_population);
+		SimulationOptions options(simulation_options);
+		options.seed = simulation_options.seed + 1000000 + naive_replicate_count;
+		vector<std::tuple<int, int, int>> epoch_statistics;
+		simulate_compartmental<SirModel>(total_epochs, neighborhood_table, population, epoch_statistics, options);
+		naive_epoch_count += static_cast<long long>(epoch_statistics.size());
+		++naive_replicate_count;
+		if (get<0>(epoch_statistics.back()) >= hit_levels.back())
+			++naive_outbreak_count;
+	}
+	execution_time = omp_get_wtime() - time_start;
+
+	std::cout << "Naive estimate: " << static_cast<double>(naive_outbreak_count) / naive_replicate_count << " (" << naive_outbreak_count << " of "
+		<< naive_replicate_count << " replicates), " << naive_epoch_count << " epochs in " << execution_time * 1000.0 << " ms" << std::endl;
+}
+
+// Simulate three co-circulating strains with partial cross immunity and report the final hit counts per strain
+void multistrain() {
+
+	string input_graph_filename = "minimumantwerp.edges";
+	int individual_count = 4000;
+	std::uint8_t total_epochs = 30;
+	int thread_count = DEFAULT_NUMBER_OF_THREADS;
+	vector<float> infectiosities = { 0.13f, 0.1f, 0.08f };
+	vector<float> cross_immunity = { 1.0f, 0.5f, 0.2f, 0.5f, 1.0f, 0.5f, 0.2f, 0.5f, 1.0f }; // Neighbouring strains protect more
+	int seeded_count = 10; // Initial infections per strain
+
+	omp_set_num_threads(thread_count);
+	std::cout << "----- Multistrain -----" << std::endl;
+
+	LocationUndirectedGraph individual_graph;
+	int location_count, edge_count;
+	vector<Individual> individuals;
+	vector<int> location_regions;
+	int region_count;
+	VenueTable venue_table;
+	reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table);
+	NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+
+	int strain_count = static_cast<int>(infectiosities.size());
+	vector<IndividualParameters> strain_parameters(strain_count);
+	for (int strain = 0; strain < strain_count; ++strain)
+		strain_parameters[strain].Infectiosity = infectiosities[strain];
+
+	vector<int> locations;
+	for (const Individual& individual : individuals)
+		locations.push_back(individual.get_location());
+	vector<std::uint32_t> strain_states(individual_count, 0);
+	for (int index = 0; index < strain_count * seeded_count && index < individual_count; ++index)
+		strain_states[index] = StrainState::infect(0, index / seeded_count);
+
+	SimulationOptions simulation_options;
+	vector<std::tuple<int, int, int>> strain_statistics;
+	double time_start = omp_get_wtime();
+	simulate_multistrain(total_epochs, neighborhood_table, locations, strain_states, strain_parameters, cross_immunity, strain_statistics, simulation_options);
+	double execution_time = omp_get_wtime() - time_start;
+
+	std::cout << strain_count << " strains in " << execution_time * 1000.0 << " ms" << std::endl;
+	for (int strain = 0; strain < strain_count; ++strain) {
+		const std::tuple<int, int, int>& statistics = strain_statistics[strain_statistics.size() - strain_count + strain];
+		std::cout << "Strain " << strain << ": hit " << get<0>(statistics) << ", infected " << get<1>(statistics) << ", recovered " << get<2>(statistics) << std::endl;
+	}
+}
+
+// Run the SEIR model over the movement layers read from edges files and a night layer that keeps everybody at their location,
+// one substep per layer and epoch
+void movement_layers() {
+
+	string input_graph_filename = "minimumantwerp.edges";
+	vector<string> layer_filenames = { "minimumantwerp.edges" }; // Day layers over the locations of the input graph
+	int individual_count = 4000;
+	std::uint8_t total_epochs = 30;
+	int thread_count = DEFAULT_NUMBER_OF_THREADS;
+
+	omp_set_num_threads(thread_count);
+	std::cout << "----- Movement Layers -----" << std::endl;
+
+	boost::unordered_map<size_t, int> map_location_to_index;
+	LocationUndirectedGraph individual_graph = GraphHandler::get_location_undirected_graph_from_file(input_graph_filename, map_location_to_index);
+	int location_count = static_cast<int>(num_vertices(individual_graph));
+	NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+
+	vector<NeighborhoodLookupTable> layer_tables = GraphHandler::get_location_layer_tables_from_files(layer_filenames, map_location_to_index);
+	NeighborhoodLookupTable night_table;
+	night_table.offsets.assign(location_count + 1, 0); // No edges, everybody stays
+	layer_tables.push_back(night_table);
+
+	vector<Individual> individuals = GraphHandler::get_random_individuals(individual_count, location_count);
+	for (int index = 0; index < INITIAL_INFECTED_COUNT; ++index)
+		individuals[index].infect();
+
+	PopulationState population;
+	population.assign(individuals);
+	SimulationOptions simulation_options;
+	for (size_t layer_index = 0; layer_index != layer_tables.size(); ++layer_index) {
+		simulation_options.layers.push_back(&layer_tables[layer_index]);
+		simulation_options.layer_schedule.push_back(static_cast<int>(layer_index));
+	}
+	simulation_options.substeps_per_epoch = static_cast<int>(layer_tables.size());
+
+	vector<std::tuple<int, int, int>> epoch_statistics;
+	double time_start = omp_get_wtime();
+	try {
+		simulate_compartmental<SeirModel>(total_epochs, neighborhood_table, population, epoch_statistics, simulation_options);
+	}
+	catch (const std::invalid_argument& error) {
+		std::cout << "Invalid layers: " << error.what() << std::endl; // A layer file with locations outside the input graph
+		return;
+	}
+	double execution_time = omp_get_wtime() - time_start;
+
+	const std::tuple<int, int, int>& statistics = epoch_statistics.back();
+	std::cout << layer_tables.size() << " layers in " << execution_time * 1000.0 << " ms" << std::endl;
+	std::cout << "Hit " << get<0>(statistics) << ", infected " << get<1>(statistics) << ", recovered " << get<2>(statistics) << std::endl;
+}
+
+// Input files that do not hold what they should stop the program with the error of the reader
+int main() try {
 
 	bool do_benchmark = false;
+	bool do_benchmark_interventions = false;
+	bool do_parameter_sweep = false;
+	bool do_calibration = false;
+	bool do_importance_splitting = false;
+	bool do_multistrain = false;
+	bool do_movement_layers = false;
 
 	if (do_benchmark) {
 		benchmark();
 	}
+	else if (do_benchmark_interventions) {
+		benchmark_interventions();
+	}
+	else if (do_parameter_sweep) {
+		parameter_sweep();
+	}
+	else if (do_calibration) {
+		calibration();
+	}
+	else if (do_importance_splitting) {
+		importance_splitting();
+	}
+	else if (do_multistrain) {
+		multistrain();
+	}
+	else if (do_movement_layers) {
+		movement_layers();
+	}
 	else {
 
 		// Get the default simulation values
@@ -392,10 +964,13 @@ int main() {
 		LocationUndirectedGraph individual_graph; //Graph of location nodes & connections
 		int location_count, edge_count;
 		vector<Individual> individuals; // Population of healthy individuals
+		vector<int> location_regions; // Region of every location, empty without a region mapping file
+		int region_count;
+		VenueTable venue_table; // Venue attributes of every location, empty without a venue attributes file
 		vector<std::tuple<int, int, int>> epoch_statistics;
 
 		// Reset individuals
-		reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals);
+		reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table);
 		std::cout << "Location Count: " << location_count << std::endl; // print info once
 		std::cout << "Edge Count: " << edge_count << std::endl; // print info once
 
@@ -405,7 +980,7 @@ int main() {
 		cout << endl << "Running serial...";
 		total_time = 0.0;
 		for (std::uint8_t current_repeat = 0; current_repeat != repeat_count; ++current_repeat) {
-			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals); // Reset individuals
+			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
 			time_start = omp_get_wtime();
 			simulate_serial_naive(individual_count, total_epochs, individual_graph, individuals);
 			time_end = omp_get_wtime() - time_start;
@@ -418,9 +993,82 @@ int main() {
 		cout << endl << "Running with OpenMP...";
 		total_time = 0.0;
 		for (std::uint8_t current_repeat = 0; current_repeat != repeat_count; ++current_repeat) {
-			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals); // Reset individuals
+			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
+			time_start = omp_get_wtime();
+			simulate_parallel(individual_count, total_epochs, individual_graph, individuals, epoch_statistics, location_regions, region_count);
+			time_end = omp_get_wtime() - time_start;
+			total_time += time_end;
+			if (!GraphHandler::assert_epidemic_results(individual_count, epoch_statistics))
+				cout << "Error." << endl;
+			cout << ".";
+		}
+		cout << (total_time / repeat_count) * 1000.0 << " ms" << endl;
+
+		// Compartment model with a latent period, on the compressed neighbourhood table
+		cout << endl << "Running SEIR model...";
+		NeighborhoodLookupTable neighborhood_table = GraphHandler::get_node_neighborhood_lookup_table(individual_graph);
+		PopulationState population;
+		TelemetryPage telemetry_page; // Published by the epoch observer, the engine does not time its phases
+		vector<int> region_statistics; // Region columns of the csv of the SEIR model, empty without a region mapping file
+		if (PUBLISH_TELEMETRY)
+			telemetry_page.open_writer(TELEMETRY_SEGMENT_NAME);
+		total_time = 0.0;
+		for (std::uint8_t current_repeat = 0; current_repeat != repeat_count; ++current_repeat) {
+			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
+			population.assign(individuals);
+			time_start = omp_get_wtime();
+			SimulationOptions simulation_options;
+			if (venue_table.node_count() > 0)
+				simulation_options.venue_table = &venue_table;
+			if (!location_regions.empty()) {
+				simulation_options.location_regions = &location_regions;
+				simulation_options.region_count = region_count;
+				simulation_options.region_statistics = &region_statistics;
+			}
+			if (telemetry_page.is_open()) {
+				simulation_options.epoch_observer = [&](int current_epoch, const std::tuple<int, int, int>& statistics) {
+					TelemetryRecord telemetry_record = TelemetryRecord();
+					telemetry_record.epoch = current_epoch;
+					telemetry_record.total_epochs = total_epochs;
+					telemetry_record.population_count = individual_count;
+					telemetry_record.susceptible_count = individual_count - get<0>(statistics); // Recovered individuals are immune
+					telemetry_record.infected_count = get<1>(statistics);
+					telemetry_record.recovered_count = get<2>(statistics);
+					telemetry_record.agent_epochs_per_second = static_cast<double>(individual_count) * (current_epoch + 1) / (omp_get_wtime() - time_start);
+					telemetry_page.publish(telemetry_record);
+					return true;
+				};
+			}
+			simulate_compartmental<SeirModel>(total_epochs, neighborhood_table, population, epoch_statistics, simulation_options);
+			time_end = omp_get_wtime() - time_start;
+			total_time += time_end;
+			if (!GraphHandler::assert_epidemic_results(individual_count, epoch_statistics))
+				cout << "Error." << endl;
+			cout << ".";
+		}
+		cout << (total_time / repeat_count) * 1000.0 << " ms" << endl;
+		if (SHOW_EPIDEMIC_RESULTS || SAVE_CSV) {
+			EpidemicMetrics epidemic_metrics(SeirModel::RULES[CompartmentInfectious].duration, INITIAL_INFECTED_COUNT);
+			vector<EpochMetrics> epoch_metrics;
+			for (const std::tuple<int, int, int>& statistics : epoch_statistics)
+				epoch_metrics.push_back(epidemic_metrics.advance_epoch(get<0>(statistics), get<1>(statistics)));
+			if (SAVE_CSV)
+				GraphHandler::save_epoch_statistics_to_csv("seir.csv", epoch_statistics, epoch_metrics, location_regions.empty() ? 0 : region_count, region_statistics);
+			if (SHOW_EPIDEMIC_RESULTS)
+				GraphHandler::show_epidemic_results(individual_count, epoch_statistics, epoch_metrics);
+		}
+
+		// Same SEIR model with the never infected individuals kept as counts per location
+		cout << endl << "Running SEIR model with susceptible counts...";
+		total_time = 0.0;
+		for (std::uint8_t current_repeat = 0; current_repeat != repeat_count; ++current_repeat) {
+			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
+			population.assign(individuals);
 			time_start = omp_get_wtime();
-			simulate_parallel(individual_count, total_epochs, individual_graph, individuals, epoch_statistics);
+			SimulationOptions simulation_options;
+			if (venue_table.node_count() > 0)
+				simulation_options.venue_table = &venue_table;
+			simulate_susceptible_counts<SeirModel>(total_epochs, neighborhood_table, population, epoch_statistics, simulation_options);
 			time_end = omp_get_wtime() - time_start;
 			total_time += time_end;
 			if (!GraphHandler::assert_epidemic_results(individual_count, epoch_statistics))
@@ -429,6 +1077,75 @@ int main() {
 		}
 		cout << (total_time / repeat_count) * 1000.0 << " ms" << endl;
 
+		// Same SEIR model, counts based at the locations where the infection is widespread
+		cout << endl << "Running hybrid SEIR model...";
+		vector<float> counts_mode_fractions;
+		total_time = 0.0;
+		for (std::uint8_t current_repeat = 0; current_repeat != repeat_count; ++current_repeat) {
+			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
+			population.assign(individuals);
+			time_start = omp_get_wtime();
+			SimulationOptions simulation_options;
+			if (venue_table.node_count() > 0)
+				simulation_options.venue_table = &venue_table;
+			simulate_hybrid<SeirModel>(total_epochs, neighborhood_table, population, HYBRID_INFECTED_THRESHOLD, epoch_statistics, counts_mode_fractions, simulation_options);
+			time_end = omp_get_wtime() - time_start;
+			total_time += time_end;
+			if (!GraphHandler::assert_epidemic_results(individual_count, epoch_statistics))
+				cout << "Error." << endl;
+			cout << ".";
+		}
+		cout << (total_time / repeat_count) * 1000.0 << " ms" << endl;
+		if (SHOW_EPIDEMIC_RESULTS) {
+			cout << "Locations in counts mode per epoch:";
+			for (float counts_mode_fraction : counts_mode_fractions)
+				cout << " " << counts_mode_fraction * 100.0f << "%";
+			cout << endl;
+		}
+
+		// Same SEIR model with sticky locations, only the individuals that leave their location are moved
+		cout << endl << "Running event driven SEIR model...";
+		total_time = 0.0;
+		for (std::uint8_t current_repeat = 0; current_repeat != repeat_count; ++current_repeat) {
+			reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
+			population.assign(individuals);
+			time_start = omp_get_wtime();
+			SimulationOptions simulation_options;
+			if (venue_table.node_count() > 0)
+				simulation_options.venue_table = &venue_table;
+			simulation_options.stay_probabilities.assign(neighborhood_table.node_count(), EVENT_DRIVEN_STAY_PROBABILITY);
+			simulate_event_driven<SeirModel>(total_epochs, neighborhood_table, population, epoch_statistics, simulation_options);
+			time_end = omp_get_wtime() - time_start;
+			total_time += time_end;
+			if (!GraphHandler::assert_epidemic_results(individual_count, epoch_statistics))
+				cout << "Error." << endl;
+			cout << ".";
+		}
+		cout << (total_time / repeat_count) * 1000.0 << " ms" << endl;
+
+		// Deterministic preview of the same population, no repeats needed
+		cout << endl << "Running mean-field preview...";
+		reset_input(input_graph_filename, individual_count, location_count, edge_count, individual_graph, individuals, location_regions, region_count, venue_table); // Reset individuals
+		population.assign(individuals);
+		time_start = omp_get_wtime();
+		SimulationOptions preview_options;
+		if (venue_table.node_count() > 0)
+			preview_options.venue_table = &venue_table;
+		simulate_mean_field(total_epochs, neighborhood_table, population, epoch_statistics, preview_options);
+		time_end = omp_get_wtime() - time_start;
+		cout << time_end * 1000.0 << " ms" << endl;
+		if (SHOW_EPIDEMIC_RESULTS) {
+			EpidemicMetrics epidemic_metrics(SirModel::RULES[CompartmentInfectious].duration, INITIAL_INFECTED_COUNT);
+			vector<EpochMetrics> epoch_metrics;
+			for (const std::tuple<int, int, int>& statistics : epoch_statistics)
+				epoch_metrics.push_back(epidemic_metrics.advance_epoch(get<0>(statistics), get<1>(statistics)));
+			GraphHandler::show_epidemic_results(individual_count, epoch_statistics, epoch_metrics);
+		}
+
 		system("pause");
 	}
-}
\ No newline at end of file
+}
+catch (const std::invalid_argument& error) {
+	std::cout << "Invalid input: " << error.what() << std::endl;
+	return 1;
+}
@@ -0,0 +1,73 @@
+#include "InterventionMask.h"
+
+// Open every node and edge of the table
+void InterventionMask::open(const NeighborhoodLookupTable& neighborhood_table) {
+	neighborhood_table_ = &neighborhood_table;
+	open_nodes_.assign(neighborhood_table.node_count(), 1);
+	open_entries_.assign(neighborhood_table.neighbours.size(), 1);
+	open_degrees_.resize(neighborhood_table.node_count());
+	for (int node = 0; node < neighborhood_table.node_count(); ++node)
+		open_degrees_[node] = neighborhood_table.degree(node);
+}
+
+// Apply a scheduled intervention
+void InterventionMask::apply(const Intervention& intervention) {
+	switch (intervention.type) {
+	case InterventionCloseNode: close_node(intervention.node); break;
+	case InterventionReopenNode: reopen_node(intervention.node); break;
+	case InterventionCloseEdge: close_edge(intervention.node, intervention.other_node); break;
+	case InterventionReopenEdge: reopen_edge(intervention.node, intervention.other_node); break;
+	}
+}
+
+// Close a node, in time linear in the degrees of the node and its neighbours
+void InterventionMask::close_node(int node) {
+	set_node(node, 0);
+}
+
+// Reopen a closed node, its edges keep their own state
+void InterventionMask::reopen_node(int node) {
+	set_node(node, 1);
+}
+
+// Close the edge between two nodes in both directions
+void InterventionMask::close_edge(int node, int other_node) {
+	set_edge(node, other_node, 0);
+}
+
+// Reopen the edge between two nodes in both directions
+void InterventionMask::reopen_edge(int node, int other_node) {
+	set_edge(node, other_node, 1);
+}
+
+// Set the flags of the table entries of an edge at both ends, nodes that are not adjacent are ignored
+void InterventionMask::set_edge(int node, int other_node, std::uint8_t open) {
+	for (int entry = neighborhood_table_->offsets[node]; entry != neighborhood_table_->offsets[node + 1]; ++entry)
+		if (neighborhood_table_->neighbours[entry] == other_node)
+			open_entries_[entry] = open;
+	for (int entry = neighborhood_table_->offsets[other_node]; entry != neighborhood_table_->offsets[other_node + 1]; ++entry)
+		if (neighborhood_table_->neighbours[entry] == node)
+			open_entries_[entry] = open;
+
+	update_open_degree(node);
+	update_open_degree(other_node);
+}
+
+// Set the flag of a node, which changes the open degree of the node and of its neighbours
+void InterventionMask::set_node(int node, std::uint8_t open) {
+	open_nodes_[node] = open;
+	update_open_degree(node);
+	for (const int* neighbour = neighborhood_table_->neighbours_begin(node); neighbour != neighborhood_table_->neighbours_end(node); ++neighbour)
+		update_open_degree(*neighbour);
+}
+
+// Recount the open neighbours of a node
+void InterventionMask::update_open_degree(int node) {
+	int open_degree = 0;
+	if (open_nodes_[node]) {
+		for (int entry = neighborhood_table_->offsets[node]; entry != neighborhood_table_->offsets[node + 1]; ++entry)
+			if (open_entries_[entry] && open_nodes_[neighborhood_table_->neighbours[entry]])
+				++open_degree;
+	}
+	open_degrees_[node] = open_degree;
+}
\ No newline at end of file
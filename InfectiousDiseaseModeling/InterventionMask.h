@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "NeighborhoodLookupTable.h"
+
+// Kind of change an intervention makes to the location graph
+enum InterventionType : std::uint8_t {
+	InterventionCloseNode,
+	InterventionReopenNode,
+	InterventionCloseEdge,
+	InterventionReopenEdge
+};
+
+// Intervention applied at the start of an epoch, node and other_node are location indices (other_node is only used by edges)
+struct Intervention {
+	int epoch;
+	InterventionType type;
+	int node;
+	int other_node;
+};
+
+// InterventionMask closes and reopens nodes and edges of a neighbourhood table without rebuilding it.
+// It keeps a flag per node and per table entry, plus the number of open neighbours of every node, so a change only
+// touches the nodes next to it. Individuals at a closed node stay there, the others never move into a closed node or over a closed edge
+class InterventionMask {
+public:
+	InterventionMask() : neighborhood_table_(nullptr) { } // Default constructor
+	void open(const NeighborhoodLookupTable& neighborhood_table);
+	void apply(const Intervention& intervention);
+	void close_node(int node);
+	void reopen_node(int node);
+	void close_edge(int node, int other_node);
+	void reopen_edge(int node, int other_node);
+	bool is_open() const;
+	bool is_node_open(int node) const;
+	int get_open_degree(int node) const;
+	int get_open_neighbour(int node, int choice) const;
+private:
+	const NeighborhoodLookupTable* neighborhood_table_;
+	std::vector<std::uint8_t> open_nodes_;
+	std::vector<std::uint8_t> open_entries_; // One flag per neighbours entry of the table, an edge has an entry at both ends
+	std::vector<int> open_degrees_; // Open neighbours reachable from every node, 0 for closed nodes
+	void set_node(int node, std::uint8_t open);
+	void set_edge(int node, int other_node, std::uint8_t open);
+	void update_open_degree(int node);
+};
+
+// Check if the mask was opened on a table
+inline bool InterventionMask::is_open() const {
+	return neighborhood_table_ != nullptr;
+}
+
+// Check if a node is open
+inline bool InterventionMask::is_node_open(int node) const {
+	return open_nodes_[node] != 0;
+}
+
+// Get the number of neighbours an individual at the node can move to
+inline int InterventionMask::get_open_degree(int node) const {
+	return open_degrees_[node];
+}
+
+// Get the choice-th open neighbour of a node, choice must be less than its open degree
+inline int InterventionMask::get_open_neighbour(int node, int choice) const {
+	int offset = neighborhood_table_->offsets[node];
+	if (open_degrees_[node] == neighborhood_table_->degree(node)) // Nothing closed around the node
+		return neighborhood_table_->neighbours[offset + choice];
+
+	for (int entry = offset; ; ++entry) {
+		if (open_entries_[entry] && open_nodes_[neighborhood_table_->neighbours[entry]] && choice-- == 0)
+			return neighborhood_table_->neighbours[entry];
+	}
+}
\ No newline at end of file
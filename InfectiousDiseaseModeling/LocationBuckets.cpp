@@ -0,0 +1,21 @@
+#include "LocationBuckets.h"
+
+// Counting sort of the individuals by location, linear in the population and the location count
+void LocationBuckets::build(const std::vector<int>& locations, int location_count) {
+
+	int individual_count = static_cast<int>(locations.size());
+
+	// Count the occupants of every location, shifted by one so the prefix sum gives the offsets
+	offsets.assign(location_count + 1, 0);
+	for (int index = 0; index < individual_count; ++index)
+		++offsets[locations[index] + 1];
+
+	for (int location = 0; location < location_count; ++location)
+		offsets[location + 1] += offsets[location];
+
+	// Scatter the individuals, every location keeps a write cursor
+	std::vector<int> cursors(offsets.begin(), offsets.end() - 1);
+	occupants.resize(individual_count);
+	for (int index = 0; index < individual_count; ++index)
+		occupants[cursors[locations[index]]++] = index;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+
+// LocationBuckets groups the individuals by their location in compressed sparse row form:
+// the individuals at location l are occupants[offsets[l]] ... occupants[offsets[l + 1] - 1], in increasing index order
+struct LocationBuckets {
+	std::vector<int> offsets; // One entry per location plus a closing entry
+	std::vector<int> occupants;
+
+	void build(const std::vector<int>& locations, int location_count);
+	int occupant_count(int location) const;
+	const int* occupants_begin(int location) const;
+	const int* occupants_end(int location) const;
+};
+
+// Get the number of individuals at a location
+inline int LocationBuckets::occupant_count(int location) const {
+	return offsets[location + 1] - offsets[location];
+}
+
+// Get a pointer to the first individual at a location
+inline const int* LocationBuckets::occupants_begin(int location) const {
+	return occupants.data() + offsets[location];
+}
+
+// Get a pointer past the last individual at a location
+inline const int* LocationBuckets::occupants_end(int location) const {
+	return occupants.data() + offsets[location + 1];
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cmath>
+#include "MeanFieldSimulation.h"
+
+// Evolve the expected occupancy of every location
+void simulate_mean_field(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population,
+	std::vector<std::tuple<int, int, int>>& epoch_statistics, const SimulationOptions& options) {
+
+	int location_count = neighborhood_table.node_count();
+	std::uint8_t durations[COMPARTMENT_COUNT];
+	get_compartment_durations<SirModel>(options, durations);
+	int infectious_duration = std::max<int>(durations[CompartmentInfectious], 1); // A duration of 0 recovers after one epoch, as advance_compartment does
+	int region_count = get_region_count(options, location_count, "simulate_mean_field");
+	const int* location_regions = region_count > 0 ? options.location_regions->data() : nullptr;
+
+	// Every location holds the expected susceptible and infected counts. The recovered individuals take no further part in the epidemic,
+	// so only their total is kept instead of moving them around, unless the region statistics need them per location. The infected
+	// individuals of all epochs share one count, the new infections of the last infectious_duration epochs are kept as totals instead,
+	// indexed by epoch modulo the duration. The counts are kept as the share that moves to every neighbour, so the movement only sums them
+	const int class_count = region_count > 0 ? 3 : 2;
+	std::vector<float> occupancy(location_count * class_count, 0.0f);
+	std::vector<float> moved_occupancy(location_count * class_count);
+	std::vector<double> epoch_new_infection_counts(infectious_duration, 0.0);
+	double hit_count = 0.0;
+	double recovered_count = 0.0;
+	for (int index = 0; index < initial_population.size(); ++index) {
+		hit_count += initial_population.hit[index];
+		if (initial_population.compartments[index] == CompartmentRecovered) {
+			recovered_count += 1.0;
+			if (region_count > 0)
+				occupancy[initial_population.locations[index] * class_count + 2] += 1.0f;
+			continue;
+		}
+		if (initial_population.compartments[index] == CompartmentSusceptible) {
+			occupancy[initial_population.locations[index] * class_count] += 1.0f;
+			continue;
+		}
+		// Exposed individuals are infected in the SIR model, infected timer epochs before epoch 0
+		occupancy[initial_population.locations[index] * class_count + 1] += 1.0f;
+		epoch_new_infection_counts[(infectious_duration - std::min<int>(initial_population.timers[index], infectious_duration - 1)) % infectious_duration] += 1.0;
+	}
+
+	// An individual stays or moves to every neighbour with the same share
+	std::vector<float> move_shares(location_count);
+	for (int location = 0; location < location_count; ++location) {
+		move_shares[location] = 1.0f / (neighborhood_table.degree(location) + 1);
+		for (int class_index = 0; class_index < class_count; ++class_index)
+			occupancy[location * class_count + class_index] *= move_shares[location];
+	}
+
+	// Expected region counts of every thread, summed in thread order so the rounded statistics do not depend on the timing of the threads
+	int thread_count = get_run_thread_count();
+	std::vector<std::vector<double>> thread_region_counts(thread_count, std::vector<double>(region_count * REGION_STATISTIC_COUNT));
+	std::vector<double> region_counts(region_count * REGION_STATISTIC_COUNT);
+
+	const float* rate_multipliers = get_rate_multipliers(options, location_count, "simulate_mean_field");
+	float log_escape_chance = std::log(1.0f - options.infectiosity);
+	float infected_share = 1.0f; // Share of the infected individuals of the previous epoch that did not recover
+	epoch_statistics.clear();
+
+	// Repeat for all the epochs
+	for (int current_epoch = 0; current_epoch < (total_epochs + 1); ++current_epoch) {
+
+		// Every location pulls its own share and the shares of its neighbours, dropping the recovered share of the infected individuals,
+		// then infects its expected susceptibles with its expected infected count
+		double new_infection_count = 0.0;
+		double infected_count = 0.0;
+		#pragma omp parallel num_threads(thread_count)
+		{
+			std::vector<double>& partial_region_counts = thread_region_counts[omp_get_thread_num()];
+			std::fill(partial_region_counts.begin(), partial_region_counts.end(), 0.0);
+
+			#pragma omp for schedule(static) reduction(+:new_infection_count, infected_count)
+			for (int location = 0; location < location_count; ++location) {
+				float susceptible = occupancy[location * class_count];
+				float infected = occupancy[location * class_count + 1];
+				for (const int* neighbour = neighborhood_table.neighbours_begin(location); neighbour != neighborhood_table.neighbours_end(location); ++neighbour) {
+					susceptible += occupancy[*neighbour * class_count];
+					infected += occupancy[*neighbour * class_count + 1];
+				}
+				float recovered = infected * (1.0f - infected_share);
+				infected *= infected_share;
+
+				float new_infections = 0.0f;
+				if (infected > 0.0f)
+					new_infections = susceptible * (1.0f - std::exp(log_escape_chance * (rate_multipliers ? rate_multipliers[location] : 1.0f) * infected));
+				moved_occupancy[location * class_count] = (susceptible - new_infections) * move_shares[location];
+				moved_occupancy[location * class_count + 1] = (infected + new_infections) * move_shares[location];
+
+				new_infection_count += new_infections;
+				infected_count += infected + new_infections;
+
+				if (region_count > 0) {
+					recovered += occupancy[location * class_count + 2];
+					for (const int* neighbour = neighborhood_table.neighbours_begin(location); neighbour != neighborhood_table.neighbours_end(location); ++neighbour)
+						recovered += occupancy[*neighbour * class_count + 2];
+					moved_occupancy[location * class_count + 2] = recovered * move_shares[location];
+
+					double* location_region_counts = &partial_region_counts[location_regions[location] * REGION_STATISTIC_COUNT];
+					location_region_counts[RegionSusceptible] += susceptible - new_infections;
+					location_region_counts[RegionInfected] += infected + new_infections; // Before the recoveries of this epoch
+					location_region_counts[RegionRecovered] += recovered;
+					location_region_counts[RegionNewInfections] += new_infections;
+				}
+			}
+		}
+		occupancy.swap(moved_occupancy);
+
+		// The individuals infected infectious_duration - 1 epochs ago recover, every location loses the same share of its infected
+		// individuals when the next epoch moves them
+		epoch_new_infection_counts[current_epoch % infectious_duration] += new_infection_count;
+		double& recovering_count = epoch_new_infection_counts[(current_epoch + 1) % infectious_duration];
+		infected_share = infected_count > 0.0 ? static_cast<float>(std::max(1.0 - recovering_count / infected_count, 0.0)) : 1.0f;
+		infected_count -= recovering_count;
+		recovered_count += recovering_count;
+		recovering_count = 0.0;
+
+		if (region_count > 0) {
+			std::fill(region_counts.begin(), region_counts.end(), 0.0);
+			for (const std::vector<double>& partial_region_counts : thread_region_counts)
+				for (size_t count_index = 0; count_index < region_counts.size(); ++count_index)
+					region_counts[count_index] += partial_region_counts[count_index];
+
+			int* epoch_region_counts = add_region_counts(options);
+			for (int region = 0; region < region_count; ++region) {
+				const double* counts = &region_counts[region * REGION_STATISTIC_COUNT];
+				epoch_region_counts[region * REGION_STATISTIC_COUNT + RegionSusceptible] = static_cast<int>(std::lround(counts[RegionSusceptible]));
+				epoch_region_counts[region * REGION_STATISTIC_COUNT + RegionInfected] = static_cast<int>(std::lround(counts[RegionInfected] * infected_share));
+				epoch_region_counts[region * REGION_STATISTIC_COUNT + RegionRecovered] = static_cast<int>(std::lround(counts[RegionRecovered]
+					+ counts[RegionInfected] * (1.0f - infected_share)));
+				epoch_region_counts[region * REGION_STATISTIC_COUNT + RegionNewInfections] = static_cast<int>(std::lround(counts[RegionNewInfections]));
+			}
+		}
+
+		hit_count += new_infection_count;
+		epoch_statistics.push_back(std::make_tuple(static_cast<int>(std::lround(hit_count)), static_cast<int>(std::lround(infected_count)),
+			static_cast<int>(std::lround(recovered_count))));
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+#include "NeighborhoodLookupTable.h"
+#include "PopulationState.h"
+
+// Deterministic mean-field preview of the SIR model: evolves the expected number of susceptible and infected individuals at every location.
+// Movement is the random walk of the individuals as one sparse matrix-vector product over the neighbourhood table per epoch, infection uses the
+// expected infected count of the location. The infected individuals recover after the infectious duration in total, every location loses
+// the same share of its infected individuals. Honours the infectiosity, the infectious compartment duration and the venue table
+// of the options, a duration of 0 counts as 1 like in the agent engines. Statistics and region statistics are the rounded expected counts per epoch.
+// Throws std::invalid_argument when the options give durations, but not one per compartment, or a location is in a missing region
+void simulate_mean_field(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population,
+	std::vector<std::tuple<int, int, int>>& epoch_statistics, const SimulationOptions& options);
\ No newline at end of file
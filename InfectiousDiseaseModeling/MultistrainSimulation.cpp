@@ -0,0 +1,161 @@
+#include <omp.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include "LocationBuckets.h"
+#include "MultistrainSimulation.h"
+
+// Simulate co-circulating strains with bit packed individual states
+void simulate_multistrain(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, std::vector<int>& locations,
+	std::vector<std::uint32_t>& strain_states, const std::vector<IndividualParameters>& strain_parameters, const std::vector<float>& cross_immunity,
+	std::vector<std::tuple<int, int, int>>& strain_statistics, const SimulationOptions& options) {
+
+	int individual_count = static_cast<int>(locations.size());
+	int location_count = neighborhood_table.node_count();
+	int strain_count = static_cast<int>(strain_parameters.size());
+
+	// The per-location strain arrays hold MAX_STRAIN_COUNT entries and the state word 8 strain flags
+	if (strain_count < 1 || strain_count > MAX_STRAIN_COUNT)
+		throw std::invalid_argument("simulate_multistrain: between 1 and MAX_STRAIN_COUNT strains are supported");
+	if (!cross_immunity.empty() && cross_immunity.size() != static_cast<size_t>(strain_count * strain_count))
+		throw std::invalid_argument("simulate_multistrain: cross_immunity must be empty or strain_count x strain_count");
+	if (strain_states.size() != locations.size())
+		throw std::invalid_argument("simulate_multistrain: one strain state per individual is required");
+	for (const IndividualParameters& parameters : strain_parameters)
+		if (parameters.DiseaseDuration == UINT8_MAX)
+			throw std::invalid_argument("simulate_multistrain: disease durations up to 254 epochs are supported"); // The epochs infected field has 8 bits
+
+	// Susceptibility to every strain for every combination of immunities, so the infection pass never walks the immunities
+	std::vector<float> susceptibilities((1 << strain_count) * strain_count);
+	for (int immune_strains = 0; immune_strains < (1 << strain_count); ++immune_strains) {
+		for (int strain = 0; strain < strain_count; ++strain) {
+			float susceptibility = 1.0f;
+			for (int immune_strain = 0; immune_strain < strain_count; ++immune_strain) {
+				if (immune_strains & (1 << immune_strain))
+					susceptibility *= 1.0f - (cross_immunity.empty() ? (immune_strain == strain ? 1.0f : 0.0f) : cross_immunity[immune_strain * strain_count + strain]);
+			}
+			susceptibilities[immune_strains * strain_count + strain] = susceptibility;
+		}
+	}
+
+	// Hazard of one infectious contact and epochs until recovery, per strain
+	std::vector<float> contact_hazards(strain_count);
+	std::vector<std::uint32_t> infection_durations(strain_count);
+	for (int strain = 0; strain < strain_count; ++strain) {
+		contact_hazards[strain] = -std::log(1.0f - strain_parameters[strain].Infectiosity);
+		infection_durations[strain] = strain_parameters[strain].DiseaseDuration + 1; // Same infectious period as Individual
+	}
+
+	// One random engine per thread of the run, seeded from the run seed and the thread number
+	int thread_count = get_run_thread_count();
+	std::vector<std::mt19937> random_engines = get_run_random_engines(options.seed, thread_count);
+
+	LocationBuckets location_buckets;
+	std::vector<int> epoch_strain_counts(strain_count * 3);
+	strain_statistics.clear();
+
+	// Repeat for all the epochs
+	for (int current_epoch = 0; current_epoch < (total_epochs + 1); ++current_epoch) {
+
+		#pragma omp parallel num_threads(thread_count)
+		move_population(neighborhood_table, nullptr, locations.data(), individual_count, random_engines[omp_get_thread_num()]);
+
+		location_buckets.build(locations, location_count);
+		epoch_strain_counts.assign(strain_count * 3, 0);
+
+		#pragma omp parallel num_threads(thread_count)
+		{
+			std::mt19937& random_engine = random_engines[omp_get_thread_num()];
+			std::uniform_real_distribution<float> real_random(0.0f, 1.0f);
+
+			// Every location counts its infectious occupants of all strains in one pass, then infects its susceptible occupants.
+			// Only the strains present at the location are visited, so the cost follows the local strain mix instead of the strain count
+			#pragma omp for schedule(static)
+			for (int location = 0; location < location_count; ++location) {
+				int infectious_counts[MAX_STRAIN_COUNT] = { 0 };
+				std::uint32_t present_strains = 0;
+				for (const int* occupant = location_buckets.occupants_begin(location); occupant != location_buckets.occupants_end(location); ++occupant) {
+					std::uint32_t infected_strains = StrainState::get_infected_strains(strain_states[*occupant]);
+					if (infected_strains) {
+						present_strains |= infected_strains;
+						++infectious_counts[StrainState::get_first_strain(infected_strains)];
+					}
+				}
+				if (!present_strains)
+					continue;
+
+				float infection_hazards[MAX_STRAIN_COUNT];
+				for (int strain = 0; strain < strain_count; ++strain)
+					infection_hazards[strain] = contact_hazards[strain] * infectious_counts[strain];
+
+				for (const int* occupant = location_buckets.occupants_begin(location); occupant != location_buckets.occupants_end(location); ++occupant) {
+					std::uint32_t state = strain_states[*occupant];
+					if (StrainState::get_infected_strains(state))
+						continue;
+
+					// The strains infect independently, the susceptibility scales the hazard of every strain. The individual escapes all of them
+					// with chance exp(-total hazard), otherwise the first infection is of a strain chosen in proportion to its hazard, so no strain
+					// is favoured by its number. The draw that decided on the infection is rescaled to choose the strain
+					const float* strain_susceptibilities = &susceptibilities[StrainState::get_immune_strains(state) * strain_count];
+					float strain_hazards[MAX_STRAIN_COUNT];
+					float total_hazard = 0.0f;
+					for (std::uint32_t remaining_strains = present_strains; remaining_strains; remaining_strains &= remaining_strains - 1) {
+						int strain = StrainState::get_first_strain(remaining_strains);
+						strain_hazards[strain] = strain_susceptibilities[strain] * infection_hazards[strain];
+						total_hazard += strain_hazards[strain];
+					}
+					float infection_chance = 1.0f - std::exp(-total_hazard);
+					float draw = real_random(random_engine);
+					if (!(draw < infection_chance))
+						continue;
+
+					draw *= total_hazard / infection_chance;
+					int strain = -1;
+					for (std::uint32_t remaining_strains = present_strains; remaining_strains; remaining_strains &= remaining_strains - 1) {
+						int candidate_strain = StrainState::get_first_strain(remaining_strains);
+						if (strain_hazards[candidate_strain] == 0.0f)
+							continue; // Immune
+						strain = candidate_strain;
+						if (draw < strain_hazards[strain])
+							break;
+						draw -= strain_hazards[strain];
+					} // Rounding leaves the last strain with a hazard
+					strain_states[*occupant] = StrainState::infect(state, strain);
+				}
+			} // Implicit Barrier
+
+			// Advance the infections and gather the statistics, in a partial histogram per thread
+			std::vector<int> partial_strain_counts(strain_count * 3, 0);
+			#pragma omp for schedule(static) nowait
+			for (int index = 0; index < individual_count; ++index) {
+				std::uint32_t state = strain_states[index];
+				if (StrainState::get_infected_strains(state)) {
+					state = StrainState::advance_epoch(state);
+					if (StrainState::get_epochs_infected(state) >= infection_durations[StrainState::get_first_strain(StrainState::get_infected_strains(state))])
+						state = StrainState::recover(state);
+					strain_states[index] = state;
+				}
+
+				std::uint32_t infected_strains = StrainState::get_infected_strains(state);
+				std::uint32_t immune_strains = StrainState::get_immune_strains(state);
+				for (std::uint32_t hit_strains = infected_strains | immune_strains; hit_strains; hit_strains &= hit_strains - 1) {
+					int strain = StrainState::get_first_strain(hit_strains);
+					int* strain_counts = &partial_strain_counts[strain * 3];
+					++strain_counts[0];
+					if (infected_strains & (1u << strain))
+						++strain_counts[1];
+					else
+						++strain_counts[2];
+				}
+			}
+
+			#pragma omp critical
+			for (int count_index = 0; count_index < strain_count * 3; ++count_index)
+				epoch_strain_counts[count_index] += partial_strain_counts[count_index];
+		} // Implicit Barrier
+
+		for (int strain = 0; strain < strain_count; ++strain)
+			strain_statistics.push_back(std::make_tuple(epoch_strain_counts[strain * 3], epoch_strain_counts[strain * 3 + 1], epoch_strain_counts[strain * 3 + 2]));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+#include "IndividualParameters.h"
+#include "NeighborhoodLookupTable.h"
+
+static const int MAX_STRAIN_COUNT = 8;
+
+// StrainState packs the state of an individual for all strains into one word: bits 0-7 flag the strain the individual is infected with
+// (at most one at a time), bits 8-15 the strains it recovered from and is immune to, bits 16-23 the epochs of the current infection
+class StrainState {
+public:
+	static std::uint32_t get_infected_strains(std::uint32_t state);
+	static std::uint32_t get_immune_strains(std::uint32_t state);
+	static std::uint32_t get_epochs_infected(std::uint32_t state);
+	static int get_first_strain(std::uint32_t strains);
+	static std::uint32_t infect(std::uint32_t state, int strain);
+	static std::uint32_t recover(std::uint32_t state);
+	static std::uint32_t advance_epoch(std::uint32_t state);
+};
+
+// Get the flag of the strain the individual is infected with, 0 when not infected
+inline std::uint32_t StrainState::get_infected_strains(std::uint32_t state) {
+	return state & 0xFFu;
+}
+
+// Get the flags of the strains the individual is immune to
+inline std::uint32_t StrainState::get_immune_strains(std::uint32_t state) {
+	return (state >> 8) & 0xFFu;
+}
+
+// Get the number of epochs the individual has been infected
+inline std::uint32_t StrainState::get_epochs_infected(std::uint32_t state) {
+	return (state >> 16) & 0xFFu;
+}
+
+// Get the lowest strain of a non-empty set of strain flags, the strain of an infection is the first of get_infected_strains
+inline int StrainState::get_first_strain(std::uint32_t strains) {
+	int strain = 0;
+	while (!(strains & (1u << strain)))
+		++strain;
+	return strain;
+}
+
+// Infect with a strain, keeping the immunities
+inline std::uint32_t StrainState::infect(std::uint32_t state, int strain) {
+	return (state & 0xFF00u) | (1u << strain);
+}
+
+// End the infection, the individual becomes immune to the strain
+inline std::uint32_t StrainState::recover(std::uint32_t state) {
+	return (state & 0xFF00u) | (get_infected_strains(state) << 8);
+}
+
+// Count one more epoch of infection
+inline std::uint32_t StrainState::advance_epoch(std::uint32_t state) {
+	return state + (1u << 16);
+}
+
+// Simulate up to MAX_STRAIN_COUNT co-circulating strains, each with its own parameters. cross_immunity is a row major strain_count x strain_count
+// matrix, the immunity to the row strain reduces the susceptibility to the column strain, which scales its infection hazard, by that fraction
+// (an empty matrix gives full immunity to the same strain only). Every epoch groups the individuals by location once and gathers the infection
+// pressure of all strains in a single pass over every location. A susceptible individual is infected with the chance to meet any of the
+// strains, by a strain chosen in proportion to its hazard. Statistics are (hit, infected, recovered) per strain and epoch, strain_count entries
+// per epoch. Runs with the same seed and thread count are reproducible, see get_run_thread_count.
+// Throws std::invalid_argument for more than MAX_STRAIN_COUNT strains, a cross_immunity matrix of the wrong size, missing strain states or
+// a disease duration of 255, whose epochs infected do not fit their 8 bits
+void simulate_multistrain(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, std::vector<int>& locations,
+	std::vector<std::uint32_t>& strain_states, const std::vector<IndividualParameters>& strain_parameters, const std::vector<float>& cross_immunity,
+	std::vector<std::tuple<int, int, int>>& strain_statistics, const SimulationOptions& options);
\ No newline at end of file
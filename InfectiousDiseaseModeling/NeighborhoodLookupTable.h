@@ -0,0 +1,34 @@
+#pragma once
+#include <vector>
+
+// NeighborhoodLookupTable stores the neighbouring nodes of every location graph node in compressed sparse row (CSR) form:
+// the neighbours of node n are neighbours[offsets[n]] ... neighbours[offsets[n + 1] - 1]
+struct NeighborhoodLookupTable {
+	std::vector<int> offsets; // One entry per node plus a closing entry
+	std::vector<int> neighbours;
+
+	int node_count() const;
+	int degree(int node) const;
+	const int* neighbours_begin(int node) const;
+	const int* neighbours_end(int node) const;
+};
+
+// Get the number of nodes in the table
+inline int NeighborhoodLookupTable::node_count() const {
+	return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1;
+}
+
+// Get the number of neighbours of a node
+inline int NeighborhoodLookupTable::degree(int node) const {
+	return offsets[node + 1] - offsets[node];
+}
+
+// Get a pointer to the first neighbour of a node
+inline const int* NeighborhoodLookupTable::neighbours_begin(int node) const {
+	return neighbours.data() + offsets[node];
+}
+
+// Get a pointer past the last neighbour of a node
+inline const int* NeighborhoodLookupTable::neighbours_end(int node) const {
+	return neighbours.data() + offsets[node + 1];
+}
\ No newline at end of file
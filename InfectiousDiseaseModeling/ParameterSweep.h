@@ -0,0 +1,73 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+#include "CompartmentalSimulation.h"
+
+// Parameters of one point of a sweep
+struct SweepPoint {
+	float infectiosity;
+	std::uint8_t disease_duration; // Epochs an individual stays infectious after the epoch it got infected, like IndividualParameters, at most 254
+	int initial_infected_count; // Individuals infectious at the start, like INITIAL_INFECTED_COUNT
+	unsigned int replicate; // Replicate of the parameters, the run seed is the seed of the base options plus the replicate
+};
+
+// Get every combination of the parameter values with replicate_count replicates each, replicates vary fastest
+inline std::vector<SweepPoint> get_sweep_points(const std::vector<float>& infectiosities, const std::vector<std::uint8_t>& disease_durations,
+	const std::vector<int>& initial_infected_counts, unsigned int replicate_count) {
+
+	std::vector<SweepPoint> sweep_points;
+	for (float infectiosity : infectiosities)
+		for (std::uint8_t disease_duration : disease_durations)
+			for (int initial_infected_count : initial_infected_counts)
+				for (unsigned int replicate = 0; replicate < replicate_count; ++replicate) {
+					SweepPoint sweep_point = { infectiosity, disease_duration, initial_infected_count, replicate };
+					sweep_points.push_back(sweep_point);
+				}
+
+	return sweep_points;
+}
+
+// Run every sweep point on a copy of the initial population over the shared neighbourhood table. The first initial_infected_count individuals
+// of the copy are infectious, like reset_input infects them, the others keep their state, so the initial population is usually all susceptible.
+// The points form an ensemble that is scheduled dynamically over the threads, one point per thread at a time. The engine of a point then runs
+// on its thread only, so a point reproduces a standalone run with its seed on one thread (see get_run_thread_count), not one on all threads.
+// point_statistics receives the (hit, infected, recovered) statistics of every point, in the order of the points.
+// Throws std::invalid_argument for a disease duration of 255, whose infectious period does not fit a compartment duration, for an initial
+// infected count outside 0 ... population size and for base options with durations, but not one per compartment
+template <typename Model>
+void run_parameter_sweep(std::uint8_t total_epochs, const NeighborhoodLookupTable& neighborhood_table, const PopulationState& initial_population,
+	const std::vector<SweepPoint>& sweep_points, const SimulationOptions& base_options, std::vector<std::vector<std::tuple<int, int, int>>>& point_statistics) {
+
+	for (const SweepPoint& sweep_point : sweep_points)
+		if (sweep_point.disease_duration == UINT8_MAX)
+			throw std::invalid_argument("run_parameter_sweep: disease durations up to 254 epochs are supported");
+	for (const SweepPoint& sweep_point : sweep_points)
+		if (sweep_point.initial_infected_count < 0 || sweep_point.initial_infected_count > initial_population.size())
+			throw std::invalid_argument("run_parameter_sweep: the initial infected count needs to be within the population");
+	std::vector<std::uint8_t> base_durations(COMPARTMENT_COUNT);
+	get_compartment_durations<Model>(base_options, base_durations.data());
+
+	int point_count = static_cast<int>(sweep_points.size());
+	point_statistics.assign(point_count, std::vector<std::tuple<int, int, int>>());
+
+	#pragma omp parallel for schedule(dynamic, 1)
+	for (int point_index = 0; point_index < point_count; ++point_index) {
+		const SweepPoint& sweep_point = sweep_points[point_index];
+
+		SimulationOptions options(base_options);
+		options.seed = base_options.seed + sweep_point.replicate;
+		options.region_statistics = nullptr; // Points run concurrently and report population totals only
+		options.infectiosity = sweep_point.infectiosity;
+		options.compartment_durations = base_durations;
+		options.compartment_durations[CompartmentInfectious] = sweep_point.disease_duration + 1; // Same infectious period as Individual
+
+		PopulationState population(initial_population); // Plain array copies
+		std::fill(population.compartments.begin(), population.compartments.begin() + sweep_point.initial_infected_count, CompartmentInfectious);
+		std::fill(population.timers.begin(), population.timers.begin() + sweep_point.initial_infected_count, 0);
+		std::fill(population.hit.begin(), population.hit.begin() + sweep_point.initial_infected_count, 1);
+		simulate_compartmental<Model>(total_epochs, neighborhood_table, population, point_statistics[point_index], options);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include "PopulationState.h"
+
+const MultiplierTable MULTIPLIER_TABLE;
+
+// Decode every quantised multiplier
+MultiplierTable::MultiplierTable() {
+	for (int code = 0; code != 256; ++code)
+		values[code] = static_cast<float>(std::exp2(static_cast<double>(code - MULTIPLIER_UNIT_CODE) / MULTIPLIER_CODES_PER_OCTAVE));
+}
+
+// Copy the locations and states of the individuals, infected individuals are infectious and keep their epochs infected
+void PopulationState::assign(const std::vector<Individual>& individuals) {
+
+	size_t individual_count = individuals.size();
+	locations.resize(individual_count);
+	compartments.resize(individual_count);
+	timers.resize(individual_count);
+	hit.resize(individual_count);
+	age_groups.clear();
+	infectivities.clear();
+	susceptibilities.clear();
+
+	for (size_t index = 0; index != individual_count; ++index) {
+		const Individual& individual = individuals[index];
+		locations[index] = individual.get_location();
+		compartments[index] = individual.is_infected() ? CompartmentInfectious : (individual.is_recovered() ? CompartmentRecovered : CompartmentSusceptible);
+		timers[index] = individual.is_infected() ? individual.get_epochs_infected() : 0;
+		hit[index] = individual.is_hit() ? 1 : 0;
+	}
+}
+
+// Draw the age group of every individual, group_shares holds the (relative) share of the population in every group
+void PopulationState::assign_random_age_groups(const std::vector<double>& group_shares, unsigned int seed) {
+
+	std::mt19937 mersenne_twister_engine(seed);
+	std::discrete_distribution<int> group_distribution(group_shares.begin(), group_shares.end());
+
+	age_groups.resize(locations.size());
+	for (size_t index = 0; index != age_groups.size(); ++index)
+		age_groups[index] = static_cast<std::uint8_t>(group_distribution(mersenne_twister_engine));
+}
+
+// Draw fat-tailed infectivity and susceptibility multipliers with mean 1 from gamma distributions, a dispersion k gives a shape k
+// (small k means few superspreaders, as in negative binomial offspring distributions) and 0 leaves the multipliers at 1.
+// The log scale quantisation keeps the near zero majority and the superspreader tail of small dispersions, the realised mean stays
+// within a fraction of a percent of 1 for dispersions down to 0.05
+void PopulationState::assign_random_multipliers(double infectivity_dispersion, double susceptibility_dispersion, unsigned int seed) {
+
+	std::mt19937 mersenne_twister_engine(seed);
+	double dispersions[] = { infectivity_dispersion, susceptibility_dispersion };
+	std::vector<std::uint8_t>* multipliers[] = { &infectivities, &susceptibilities };
+
+	for (int multiplier_index = 0; multiplier_index != 2; ++multiplier_index) {
+		multipliers[multiplier_index]->clear();
+		if (dispersions[multiplier_index] <= 0.0)
+			continue;
+
+		std::gamma_distribution<double> gamma_distribution(dispersions[multiplier_index], 1.0 / dispersions[multiplier_index]);
+		multipliers[multiplier_index]->resize(locations.size());
+		for (size_t index = 0; index != locations.size(); ++index) {
+			(*multipliers[multiplier_index])[index] = get_quantised_multiplier(gamma_distribution(mersenne_twister_engine));
+		}
+	}
+}
\ No newline at end of file
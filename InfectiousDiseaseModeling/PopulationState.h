@@ -0,0 +1,54 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "CompartmentModel.h"
+#include "Individual.h"
+
+// Quantised infectivity and susceptibility multipliers are stored in 8 bits on a log scale: code c stands for
+// 2^((c - MULTIPLIER_UNIT_CODE) / MULTIPLIER_CODES_PER_OCTAVE). Neighbouring codes differ by about 9%, the codes cover 2^-24 ... 2^7.875 (about 235),
+// smaller multipliers saturate at the lowest code and larger ones at the highest
+static const int MULTIPLIER_CODES_PER_OCTAVE = 8;
+static const int MULTIPLIER_UNIT_CODE = 192; // Code of the multiplier 1
+
+// Multiplier of every code, filled once at startup so decoding is a table lookup in the infection kernels
+struct MultiplierTable {
+	MultiplierTable();
+	float values[256];
+};
+extern const MultiplierTable MULTIPLIER_TABLE;
+
+// PopulationState holds the population as a structure of arrays, one entry per individual, for the compartment model kernels
+struct PopulationState {
+	std::vector<int> locations;
+	std::vector<std::uint8_t> compartments; // Compartment of every individual
+	std::vector<std::uint8_t> timers; // Epochs spent in the current compartment
+	std::vector<std::uint8_t> hit; // Indicates if the individual was infected at some point
+	std::vector<std::uint8_t> age_groups; // Age group of every individual, everybody is in group 0 when empty
+	std::vector<std::uint8_t> infectivities; // Quantised infectivity multiplier of every individual, all 1 when empty
+	std::vector<std::uint8_t> susceptibilities; // Quantised susceptibility multiplier of every individual, all 1 when empty
+
+	void assign(const std::vector<Individual>& individuals);
+	void assign_random_age_groups(const std::vector<double>& group_shares, unsigned int seed);
+	void assign_random_multipliers(double infectivity_dispersion, double susceptibility_dispersion, unsigned int seed);
+	int size() const;
+};
+
+// Get a multiplier from its quantised value
+inline float get_multiplier(std::uint8_t quantised_multiplier) {
+	return MULTIPLIER_TABLE.values[quantised_multiplier];
+}
+
+// Get the code of the nearest quantised multiplier, rounding on the log scale
+inline std::uint8_t get_quantised_multiplier(double multiplier) {
+	if (multiplier <= 0.0)
+		return 0;
+	double code = std::floor(std::log2(multiplier) * MULTIPLIER_CODES_PER_OCTAVE + 0.5) + MULTIPLIER_UNIT_CODE;
+	return static_cast<std::uint8_t>(std::max(0.0, std::min(code, 255.0)));
+}
+
+// Get the number of individuals
+inline int PopulationState::size() const {
+	return static_cast<int>(locations.size());
+}
\ No newline at end of file
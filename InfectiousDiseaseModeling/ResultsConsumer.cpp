@@ -0,0 +1,50 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "ResultsStream.h"
+#include "Settings.h"
+
+// Print the results stream of a running simulation as csv until the simulation finishes.
+// Location deltas are printed as extra location:delta columns. A stream that is already finished when the consumer attaches was left
+// by an earlier run, so the consumer waits for the next run to create a new generation of it
+
+int main() {
+
+	// The consumer may start before the simulation creates the stream, wait for it a little while
+	ResultsStream results_stream;
+	for (int attempt = 0; !results_stream.open_consumer(RESULTS_STREAM_SEGMENT_NAME) || results_stream.is_finished(); ++attempt) {
+		if (attempt == 1000) {
+			std::cout << "No running results stream at " << RESULTS_STREAM_SEGMENT_NAME << std::endl;
+			return 1;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	std::uint64_t generation = results_stream.get_generation();
+
+	std::cout << "epoch,hitcount,infectedcount,recoveredcount,newinfections,growthrate,reproductionnumber,locationdeltas" << std::endl;
+	while (true) {
+		if (results_stream.get_generation() != generation) {
+			std::cerr << "The results stream was recreated by another run" << std::endl;
+			break;
+		}
+		bool finished = results_stream.is_finished(); // Check before draining, so records published just before finishing are not missed
+		const ResultsRecord* record;
+		while ((record = results_stream.acquire()) != nullptr) {
+			std::cout << record->epoch << "," << record->hit_count << "," << record->infected_count << "," << record->recovered_count
+				<< "," << record->new_infections << "," << record->growth_rate << "," << record->reproduction_number << ","
+				<< record->location_delta_count << (record->location_deltas_truncated ? "+" : "");
+			const LocationDelta* location_deltas = results_stream.get_location_deltas(record);
+			for (int delta_index = 0; delta_index != record->location_delta_count; ++delta_index)
+				std::cout << "," << location_deltas[delta_index].location << ":" << location_deltas[delta_index].infected_delta;
+			std::cout << "\n";
+			results_stream.release();
+		}
+		if (finished)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	std::cout << std::flush;
+	std::cerr << "Dropped records: " << results_stream.get_dropped_count() << std::endl;
+	return 0;
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+#include "ResultsStream.h"
+
+// Create the segment with an empty ring of slot_count slots and a new generation. A segment left by an earlier run is reinitialised.
+// full_policy decides if publish waits, at most max_wait_microseconds per record, for a consumer that lags behind
+bool ResultsStream::open_producer(const std::string& name, int slot_count, int max_location_deltas, int location_count, ResultsStreamFullPolicy full_policy,
+	int max_wait_microseconds) {
+
+	size_t header_size = (sizeof(ResultsStreamHeader) + 63) / 64 * 64;
+	size_t slot_size = (sizeof(ResultsRecord) + sizeof(LocationDelta) * max_location_deltas + 63) / 64 * 64; // Slots start on a cache line
+
+	if (slot_count <= 0 || !segment_.create(name, header_size + slot_size * slot_count))
+		return false;
+	full_policy_ = full_policy;
+	max_wait_microseconds_ = max_wait_microseconds;
+
+	ResultsStreamHeader* header = new (segment_.get_address()) ResultsStreamHeader; // Construct the header in the shared memory
+	header->magic = 0; // Consumers reject the segment until it is initialised again
+	std::atomic_thread_fence(std::memory_order_release);
+	header->generation = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count());
+	header->header_size = static_cast<std::uint32_t>(header_size);
+	header->slot_size = static_cast<std::uint32_t>(slot_size);
+	header->slot_count = static_cast<std::uint32_t>(slot_count);
+	header->max_location_deltas = max_location_deltas;
+	header->location_count = location_count;
+	header->finished.store(0, std::memory_order_relaxed);
+	header->write_count.store(0, std::memory_order_relaxed);
+	header->read_count.store(0, std::memory_order_relaxed);
+	header->dropped_count.store(0, std::memory_order_relaxed);
+	header->version = VERSION;
+	std::atomic_thread_fence(std::memory_order_release);
+	header->magic = MAGIC; // Consumers only accept the segment once everything else is in place
+	return true;
+}
+
+// Wait for the consumer to free the slot of the record write_count, following the full policy. Returns false when the slot is still unread
+bool ResultsStream::wait_for_free_slot(std::uint64_t write_count) const {
+
+	ResultsStreamHeader* header = get_header();
+	if (write_count - header->read_count.load(std::memory_order_acquire) < header->slot_count)
+		return true;
+	if (full_policy_ == ResultsStreamDrop)
+		return false;
+
+	// Yield to the consumer instead of burning the core it may need, the clock bounds the wait if the consumer is gone
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(max_wait_microseconds_);
+	while (write_count - header->read_count.load(std::memory_order_acquire) >= header->slot_count) {
+		if (std::chrono::steady_clock::now() >= deadline)
+			return false;
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+// Copy a record and its location deltas into the next free slot. Returns false when the consumer has not freed a slot in time and
+// the record is dropped
+bool ResultsStream::publish(const ResultsRecord& record, const std::vector<LocationDelta>& location_deltas) {
+
+	ResultsStreamHeader* header = get_header();
+	std::uint64_t write_count = header->write_count.load(std::memory_order_relaxed);
+
+	if (!wait_for_free_slot(write_count)) {
+		header->dropped_count.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	char* slot = get_slot(write_count);
+	ResultsRecord* slot_record = reinterpret_cast<ResultsRecord*>(slot);
+	*slot_record = record;
+
+	int location_delta_count = static_cast<int>(location_deltas.size());
+	slot_record->location_deltas_truncated = (location_delta_count > header->max_location_deltas) ? 1 : 0;
+	slot_record->location_delta_count = slot_record->location_deltas_truncated ? header->max_location_deltas : location_delta_count;
+	if (slot_record->location_delta_count > 0)
+		std::memcpy(slot_record + 1, location_deltas.data(), sizeof(LocationDelta) * slot_record->location_delta_count);
+
+	header->write_count.store(write_count + 1, std::memory_order_release); // Hand the slot over to the consumer
+	return true;
+}
+
+// Tell the consumer that no more records will follow
+void ResultsStream::finish() {
+	get_header()->finished.store(1, std::memory_order_release);
+}
+
+// Map a stream created by a producer
+bool ResultsStream::open_consumer(const std::string& name) {
+
+	if (!segment_.open(name, true)) // The consumer writes read_count
+		return false;
+
+	if (segment_.get_size() < sizeof(ResultsStreamHeader) || get_header()->magic != MAGIC || get_header()->version != VERSION) {
+		segment_.close();
+		return false;
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return true;
+}
+
+// Get the oldest unread record in place, nullptr when the consumer has caught up with the producer
+const ResultsRecord* ResultsStream::acquire() const {
+
+	ResultsStreamHeader* header = get_header();
+	std::uint64_t read_count = header->read_count.load(std::memory_order_relaxed);
+
+	if (read_count == header->write_count.load(std::memory_order_acquire))
+		return nullptr;
+	return reinterpret_cast<const ResultsRecord*>(get_slot(read_count));
+}
+
+// Give the slot of the acquired record back to the producer
+void ResultsStream::release() {
+	ResultsStreamHeader* header = get_header();
+	header->read_count.store(header->read_count.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Check if the producer finished. Records published before finishing may still be unread
+bool ResultsStream::is_finished() const {
+	return get_header()->finished.load(std::memory_order_acquire) != 0;
+}
+
+// Get the generation of the run that created the segment, it changes when a new run reuses the segment
+std::uint64_t ResultsStream::get_generation() const {
+	return get_header()->generation;
+}
+
+// Get the number of records the producer dropped because the ring was full, right away or after waiting
+std::uint64_t ResultsStream::get_dropped_count() const {
+	return get_header()->dropped_count.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "SharedMemorySegment.h"
+
+// Change of the infected count of one location since the previous epoch
+struct LocationDelta {
+	int location;
+	int infected_delta;
+};
+
+// Statistics of one epoch as published in the stream
+struct ResultsRecord {
+	int epoch;
+	int hit_count;
+	int infected_count;
+	int recovered_count;
+	int new_infections;
+	int location_delta_count; // Number of LocationDelta entries that follow the record in its slot
+	int location_deltas_truncated; // 1 when more locations changed than a slot can hold
+	int padding;
+	double growth_rate;
+	double reproduction_number;
+};
+
+// Layout of the shared memory segment, all offsets in bytes from the start of the segment:
+//   0                      ResultsStreamHeader
+//   header_size            slot 0: ResultsRecord followed by max_location_deltas LocationDelta entries
+//   header_size + slot_size * i   slot i, for i < slot_count
+// The producer fills slot (write_count % slot_count) and then increments write_count. The consumer reads slot
+// (read_count % slot_count) in place while read_count < write_count and then increments read_count.
+// When all slots are unread the producer follows the policy it was opened with, waiting for the consumer a bounded time or not at all.
+// A record that still finds the ring full is dropped and dropped_count is incremented.
+// The segment is reused by the next run, which gives it a new generation, so a consumer can tell a finished earlier run from the current one
+struct ResultsStreamHeader {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::uint32_t header_size;
+	std::uint32_t slot_size;
+	std::uint32_t slot_count;
+	std::int32_t max_location_deltas;
+	std::int32_t location_count;
+	std::uint64_t generation; // Creation stamp of the run, the segment name outlives the run that created it
+	std::atomic<std::uint32_t> finished; // Set by the producer after the last record
+	alignas(64) std::atomic<std::uint64_t> write_count; // Producer and consumer counters live on separate cache lines
+	alignas(64) std::atomic<std::uint64_t> read_count;
+	alignas(64) std::atomic<std::uint64_t> dropped_count;
+};
+
+// What the producer does when the consumer has not freed a slot for the next record
+enum ResultsStreamFullPolicy : std::uint8_t {
+	ResultsStreamWait, // Yield until the consumer frees a slot, up to the maximum wait of the producer, then drop the record
+	ResultsStreamDrop // Drop the record right away, the producer never waits
+};
+
+// ResultsStream is a single producer, single consumer ring buffer of per-epoch results in shared memory.
+// The simulation is the producer; a consumer process on the same host maps the same segment and reads the records without copying
+class ResultsStream {
+public:
+	ResultsStream() : full_policy_(ResultsStreamDrop), max_wait_microseconds_(0) { } // Default constructor
+	bool open_producer(const std::string& name, int slot_count, int max_location_deltas, int location_count, ResultsStreamFullPolicy full_policy,
+		int max_wait_microseconds);
+	bool publish(const ResultsRecord& record, const std::vector<LocationDelta>& location_deltas);
+	void finish();
+	bool open_consumer(const std::string& name);
+	const ResultsRecord* acquire() const;
+	const LocationDelta* get_location_deltas(const ResultsRecord* record) const;
+	void release();
+	bool is_finished() const;
+	std::uint64_t get_generation() const;
+	std::uint64_t get_dropped_count() const;
+	bool is_open() const;
+private:
+	SharedMemorySegment segment_;
+	ResultsStreamFullPolicy full_policy_;
+	int max_wait_microseconds_;
+	bool wait_for_free_slot(std::uint64_t write_count) const;
+	ResultsStreamHeader* get_header() const;
+	char* get_slot(std::uint64_t index) const;
+	static const std::uint32_t MAGIC = 0x53524D44; // "DMRS"
+	static const std::uint32_t VERSION = 2;
+};
+
+// Check if the stream is mapped
+inline bool ResultsStream::is_open() const {
+	return segment_.get_address() != nullptr;
+}
+
+// Get the location deltas that follow a record acquired from the stream
+inline const LocationDelta* ResultsStream::get_location_deltas(const ResultsRecord* record) const {
+	return reinterpret_cast<const LocationDelta*>(record + 1);
+}
+
+inline ResultsStreamHeader* ResultsStream::get_header() const {
+	return static_cast<ResultsStreamHeader*>(segment_.get_address());
+}
+
+inline char* ResultsStream::get_slot(std::uint64_t index) const {
+	ResultsStreamHeader* header = get_header();
+	return static_cast<char*>(segment_.get_address()) + header->header_size + (index % header->slot_count) * header->slot_size;
+}
@@ -10,6 +10,57 @@ static const bool SAVE_CSV = false;
 static const bool SAVE_GRAPHVIZ = false;
 static const bool SHOW_EPIDEMIC_RESULTS = false;
 
+// Region mapping file with one "openstreet map node id,region" line per location, statistics per region are saved as columns of the csv (empty disables them)
+static const char* const REGION_MAPPING_FILENAME = "";
+
+// Venue attributes file with one "openstreet map node id,rate multiplier,capacity,type" line per venue, used by the compartment models (empty disables it)
+static const char* const VENUE_ATTRIBUTES_FILENAME = "";
+
+// Per-epoch graphviz frames coloured by prevalence, restricted to the neighbourhood of the hotspots (0 hotspots writes the whole graph)
+static const bool SAVE_GRAPHVIZ_FRAMES = false;
+static const int GRAPHVIZ_HOTSPOT_COUNT = 10;
+static const int GRAPHVIZ_HOP_COUNT = 3;
+
+// Live progress of simulate_parallel and of the SEIR run of simulate_compartmental in a shared memory page (/dev/shm on Linux), read it with telemetryreader
+static const bool PUBLISH_TELEMETRY = false;
+static const char* const TELEMETRY_SEGMENT_NAME = "/diseasemodeling_telemetry";
+
+// Per-epoch results of simulate_parallel in a shared memory ring buffer, read it with resultsconsumer.
+// Every slot holds up to RESULTS_STREAM_MAX_LOCATION_DELTAS changed location infected counts (0 disables the deltas)
+static const bool PUBLISH_RESULTS_STREAM = false;
+static const char* const RESULTS_STREAM_SEGMENT_NAME = "/diseasemodeling_results";
+static const int RESULTS_STREAM_SLOT_COUNT = 64;
+static const int RESULTS_STREAM_MAX_LOCATION_DELTAS = 4096;
+// A full ring makes simulate_parallel wait for the consumer up to RESULTS_STREAM_MAX_WAIT_MICROSECONDS per epoch before dropping the record,
+// or drop it right away when RESULTS_STREAM_DROP_WHEN_FULL is set so a slow consumer never slows the simulation
+static const bool RESULTS_STREAM_DROP_WHEN_FULL = false;
+static const int RESULTS_STREAM_MAX_WAIT_MICROSECONDS = 100000;
+
+// Per-epoch binary frames with the prevalence class of every location, skipped when they exceed FRAME_BYTES_PER_EPOCH on average.
+// The budget must hold one bit packed frame (12 + location count / 4 bytes) in its burst of 4 epochs, frames are disabled otherwise
+static const bool SAVE_FRAMES = false;
+static const char* const FRAMES_FILENAME = "frames.bin";
+static const size_t FRAME_BYTES_PER_EPOCH = 16384;
+
+// Co-location index of the last CONTACT_TRACING_WINDOW epochs, queried for the contacts of every newly infected individual
+static const bool TRACE_CONTACTS = false;
+static const int CONTACT_TRACING_WINDOW = 10;
+
+// Semicolon separated analyser plugins (shared objects exporting create_analyser), run every ANALYSER_EPOCH_INTERVAL epochs and after the last one
+static const char* const ANALYSER_PLUGIN_PATHS = "";
+static const int ANALYSER_EPOCH_INTERVAL = 1;
+
+// Trajectories of a random cohort of COHORT_SIZE individuals, optionally stratified by their initial state, saved with the csv
+static const bool TRACK_COHORT = false;
+static const int COHORT_SIZE = 100;
+static const bool COHORT_STRATIFIED = true;
+
+// Locations with at least this many infected individuals are simulated as counts instead of agents by the hybrid engine
+static const int HYBRID_INFECTED_THRESHOLD = 2;
+
+// Chance of every individual to stay at its location per epoch in the event driven engine
+static const float EVENT_DRIVEN_STAY_PROBABILITY = 0.9f;
+
 static const int DEFAULT_NUMBER_OF_THREADS = 4;
 
 static const std::uint8_t DEFAULT_TOTAL_EPOCHS = 30;
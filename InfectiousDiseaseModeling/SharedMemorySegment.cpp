@@ -0,0 +1,77 @@
+#include "SharedMemorySegment.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+SharedMemorySegment::~SharedMemorySegment() {
+	close();
+}
+
+// Create (or resize) the named segment and map it read-write. The segment outlives the process so readers can inspect the last state
+bool SharedMemorySegment::create(const std::string& name, size_t size) {
+#if defined(__unix__) || defined(__APPLE__)
+	close();
+
+	int file_descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+	if (file_descriptor < 0)
+		return false;
+
+	if (ftruncate(file_descriptor, static_cast<off_t>(size)) != 0) {
+		::close(file_descriptor);
+		return false;
+	}
+
+	void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file_descriptor, 0);
+	::close(file_descriptor); // The mapping keeps the segment alive
+	if (address == MAP_FAILED)
+		return false;
+
+	address_ = address;
+	size_ = size;
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Map an existing named segment with its current size
+bool SharedMemorySegment::open(const std::string& name, bool writable) {
+#if defined(__unix__) || defined(__APPLE__)
+	close();
+
+	int file_descriptor = shm_open(name.c_str(), writable ? O_RDWR : O_RDONLY, 0);
+	if (file_descriptor < 0)
+		return false;
+
+	struct stat segment_stat;
+	if (fstat(file_descriptor, &segment_stat) != 0 || segment_stat.st_size == 0) {
+		::close(file_descriptor);
+		return false;
+	}
+
+	size_t size = static_cast<size_t>(segment_stat.st_size);
+	void* address = mmap(nullptr, size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, file_descriptor, 0);
+	::close(file_descriptor);
+	if (address == MAP_FAILED)
+		return false;
+
+	address_ = address;
+	size_ = size;
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Unmap the segment, the named object itself stays in place
+void SharedMemorySegment::close() {
+#if defined(__unix__) || defined(__APPLE__)
+	if (address_ != nullptr)
+		munmap(address_, size_);
+#endif
+	address_ = nullptr;
+	size_ = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+
+// SharedMemorySegment maps a named POSIX shared memory object (under /dev/shm on Linux) into the address space of the process.
+// On platforms without POSIX shared memory create and open always fail
+class SharedMemorySegment {
+public:
+	SharedMemorySegment() : address_(nullptr), size_(0) { } // Default constructor
+	~SharedMemorySegment();
+	bool create(const std::string& name, size_t size);
+	bool open(const std::string& name, bool writable);
+	void close();
+	void* get_address() const;
+	size_t get_size() const;
+private:
+	void* address_;
+	size_t size_;
+	SharedMemorySegment(const SharedMemorySegment&); // Mappings are not copyable
+	SharedMemorySegment& operator=(const SharedMemorySegment&);
+};
+
+// Get the start of the mapped segment, nullptr when nothing is mapped
+inline void* SharedMemorySegment::get_address() const {
+	return address_;
+}
+
+// Get the size of the mapped segment in bytes
+inline size_t SharedMemorySegment::get_size() const {
+	return size_;
+}
@@ -0,0 +1,60 @@
+#include <cstring>
+#include <new>
+#include "TelemetryPage.h"
+
+// Create the page and reset it to an empty record
+bool TelemetryPage::open_writer(const std::string& name) {
+
+	if (!segment_.create(name, sizeof(TelemetryPageLayout)))
+		return false;
+
+	TelemetryPageLayout* layout = new (segment_.get_address()) TelemetryPageLayout; // Construct the layout in the shared memory
+	layout->sequence.store(0, std::memory_order_relaxed);
+	std::memset(&layout->record, 0, sizeof(TelemetryRecord));
+	layout->version = VERSION;
+	layout->magic = MAGIC;
+	return true;
+}
+
+// Map a page created by a writer, fails if the segment is not a telemetry page
+bool TelemetryPage::open_reader(const std::string& name) {
+
+	if (!segment_.open(name, false))
+		return false;
+
+	if (segment_.get_size() < sizeof(TelemetryPageLayout) || get_layout()->magic != MAGIC || get_layout()->version != VERSION) {
+		segment_.close();
+		return false;
+	}
+	return true;
+}
+
+// Replace the record. An odd sequence tells the readers that an update is in progress
+void TelemetryPage::publish(const TelemetryRecord& record) {
+
+	TelemetryPageLayout* layout = get_layout();
+	std::uint64_t sequence = layout->sequence.load(std::memory_order_relaxed);
+
+	layout->sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release); // The odd sequence is visible before any byte of the record changes
+	std::memcpy(&layout->record, &record, sizeof(TelemetryRecord));
+	layout->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Copy a consistent snapshot of the record, false if the writer kept updating it during every attempt
+bool TelemetryPage::read(TelemetryRecord& record) const {
+
+	const TelemetryPageLayout* layout = get_layout();
+	for (int attempt = 0; attempt != MAX_READ_ATTEMPTS; ++attempt) {
+		std::uint64_t sequence_before = layout->sequence.load(std::memory_order_acquire);
+		if (sequence_before & 1)
+			continue; // Update in progress
+
+		std::memcpy(&record, &layout->record, sizeof(TelemetryRecord));
+		std::atomic_thread_fence(std::memory_order_acquire); // The copy completes before the sequence is checked again
+
+		if (layout->sequence.load(std::memory_order_relaxed) == sequence_before)
+			return true;
+	}
+	return false;
+}
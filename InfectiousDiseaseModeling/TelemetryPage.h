@@ -0,0 +1,53 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include "SharedMemorySegment.h"
+
+// Progress of a running simulation, published once per epoch
+struct TelemetryRecord {
+	int epoch;
+	int total_epochs;
+	int population_count;
+	int susceptible_count;
+	int infected_count;
+	int recovered_count;
+	double move_time_ms; // Time spent in each phase of the last epoch, 0 from engines that do not time their phases (simulate_compartmental)
+	double infect_time_ms;
+	double advance_time_ms;
+	double agent_epochs_per_second; // Throughput since the start of the simulation
+};
+
+// Layout of the shared memory page. The sequence is odd while the writer updates the record (seqlock)
+struct TelemetryPageLayout {
+	std::uint32_t magic;
+	std::uint32_t version;
+	std::atomic<std::uint64_t> sequence;
+	TelemetryRecord record;
+};
+
+// TelemetryPage is a single writer, many readers shared memory page holding the latest TelemetryRecord.
+// The writer never waits for readers; readers retry when they observe a torn update
+class TelemetryPage {
+public:
+	bool open_writer(const std::string& name);
+	bool open_reader(const std::string& name);
+	void publish(const TelemetryRecord& record);
+	bool read(TelemetryRecord& record) const;
+	bool is_open() const;
+private:
+	SharedMemorySegment segment_;
+	TelemetryPageLayout* get_layout() const;
+	static const std::uint32_t MAGIC = 0x544C4D44; // "DMLT"
+	static const std::uint32_t VERSION = 1;
+	static const int MAX_READ_ATTEMPTS = 1000;
+};
+
+// Check if the page is mapped
+inline bool TelemetryPage::is_open() const {
+	return segment_.get_address() != nullptr;
+}
+
+inline TelemetryPageLayout* TelemetryPage::get_layout() const {
+	return static_cast<TelemetryPageLayout*>(segment_.get_address());
+}
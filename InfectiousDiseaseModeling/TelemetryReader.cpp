@@ -0,0 +1,48 @@
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include "TelemetryPage.h"
+#include "Settings.h"
+
+// Print the telemetry page of a running simulation once, or keep printing every new epoch with --tail [interval_ms]
+
+void print_record(const TelemetryRecord& record) {
+	std::cout << "Epoch " << record.epoch << "/" << record.total_epochs
+		<< " S: " << record.susceptible_count << " I: " << record.infected_count << " R: " << record.recovered_count
+		<< " move: " << record.move_time_ms << " ms infect: " << record.infect_time_ms << " ms advance: " << record.advance_time_ms << " ms"
+		<< " throughput: " << record.agent_epochs_per_second << " agent-epochs/s" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+	bool tail = (argc > 1) && (std::strcmp(argv[1], "--tail") == 0);
+	int interval_ms = (tail && argc > 2) ? std::atoi(argv[2]) : 500;
+
+	TelemetryPage telemetry_page;
+	if (!telemetry_page.open_reader(TELEMETRY_SEGMENT_NAME)) {
+		std::cout << "No telemetry page at " << TELEMETRY_SEGMENT_NAME << std::endl;
+		return 1;
+	}
+
+	TelemetryRecord record;
+	if (!tail) {
+		if (!telemetry_page.read(record))
+			return 1;
+		print_record(record);
+		return 0;
+	}
+
+	int last_printed_epoch = -1;
+	while (true) {
+		if (telemetry_page.read(record) && record.epoch != last_printed_epoch && record.total_epochs > 0) {
+			print_record(record);
+			last_printed_epoch = record.epoch;
+			if (record.epoch == record.total_epochs)
+				break; // The simulation finished
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+	}
+	return 0;
+}
@@ -0,0 +1,8 @@
+#include "VenueTable.h"
+
+// Make every location a residential venue of unknown capacity with the base transmission rate
+void VenueTable::assign_defaults(int location_count) {
+	rate_multipliers.assign(location_count, 1.0f);
+	capacities.assign(location_count, 0);
+	types.assign(location_count, VenueResidential);
+}
\ No newline at end of file
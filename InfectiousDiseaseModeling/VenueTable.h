@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Kind of venue at a location
+enum VenueType : std::uint8_t {
+	VenueResidential,
+	VenueTransit,
+	VenueMarket,
+	VenueOther
+};
+
+// VenueTable holds the venue attributes of the locations as a structure of arrays, aligned with the rows of the neighbourhood table
+struct VenueTable {
+	std::vector<float> rate_multipliers; // Scales the transmission at the location
+	std::vector<int> capacities; // Individuals the venue holds, 0 when unknown
+	std::vector<std::uint8_t> types; // VenueType of the location
+
+	void assign_defaults(int location_count);
+	int node_count() const;
+};
+
+// Get the number of locations in the table
+inline int VenueTable::node_count() const {
+	return static_cast<int>(rate_multipliers.size());
+}
\ No newline at end of file